@@ -136,6 +136,9 @@ namespace MyApp
 		SdlManager sdl_; // Responsible for managing user input and for graphical rendering.
 		AudioEngine audioEngine_; // Responsible for servicing the audio.
 		AssetManager assetManager_{}; // Responsible for managing assets.
+		std::shared_ptr<const AudioAsset> generatedAsset_; // The signals to play, made AudioAssets once so that switching between them doesn't copy them.
+		std::shared_ptr<const AudioAsset> generatedFromDFTAsset_; // Idem.
+		std::shared_ptr<const AudioAsset> synthesizedFromDFTAsset_; // Idem.
 
 		static constexpr const MyMath::Box BOUNDS{ -2.0f, 2.0f, -2.0f, 2.0f, -2.0f, 2.0f }; // Bounds of the space in which objects are rendered.
 		static constexpr const MyMath::Mat4x4 ORTHO_PROJ_MAT = MyMath::OrthogonalProjectionMatrix(BOUNDS.back, BOUNDS.front, BOUNDS.right, BOUNDS.left, BOUNDS.bottom, BOUNDS.top); // Projection matrix used.
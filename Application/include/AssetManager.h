@@ -2,11 +2,14 @@
 
 #include <vector>
 #include <complex>
+#include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace MyApp
 {
 	/**
-	* Represents a (TODO)unique audio clip loaded from disk or created by a user.
+	* Represents a unique audio clip loaded from disk or created by a user. Immutable, so that any number of Sounds can share it through a std::shared_ptr<const AudioAsset> without copying the samples nor synchronizing.
 	*/
 	class AudioAsset
 	{
@@ -18,17 +21,52 @@ namespace MyApp
 		* @param data Monophonic signal whose data is to be copied.
 		*/
 		AudioAsset(const std::vector<float>& data);
+		/**
+		* Constructs an AudioAsset without copying the samples.
+		*
+		* @param data Monophonic signal whose data is to be moved from.
+		*/
+		AudioAsset(std::vector<float>&& data);
 
 		const std::vector<float> data; // Holds a monophonic signal.
 	};
 
 	/**
 	* Responsible for loading and unloading assets. For now, only handles wav files.
-	* TODO: add hashing to avoid loading the same file multiple times.
+	* Audio clips are loaded once per path and handed out as shared AudioAssets, kept alive as long as the AssetManager or a Sound holds them.
 	*/
 	class AssetManager
 	{
 	public:
+		/**
+		* Returns the AudioAsset of a wav file, loading it the first time only.
+		*
+		* @param path Relative path of the wav file.
+		* @return The shared clip. Throws if the file couldn't be loaded.
+		*/
+		std::shared_ptr<const AudioAsset> LoadAudioAsset(const char* path);
+
+		/**
+		* Makes an AudioAsset of a signal created by the user, held by the AssetManager until ReleaseUnusedAssets().
+		*
+		* @param data Monophonic signal whose data is to be copied.
+		* @return The shared clip.
+		*/
+		std::shared_ptr<const AudioAsset> CreateAudioAsset(const std::vector<float>& data);
+
+		/**
+		* Makes an AudioAsset of a signal created by the user without copying it, held by the AssetManager until ReleaseUnusedAssets().
+		*
+		* @param data Monophonic signal whose data is to be moved from.
+		* @return The shared clip.
+		*/
+		std::shared_ptr<const AudioAsset> CreateAudioAsset(std::vector<float>&& data);
+
+		/**
+		* Drops the AssetManager's references to the AudioAssets nothing else holds anymore, freeing them.
+		*/
+		void ReleaseUnusedAssets();
+
 		/**
 		* Loads and returns the wav data of a wav file.
 		* 
@@ -87,6 +125,7 @@ namespace MyApp
 		static bool ReadCarr(std::vector<std::complex<float>>& out, const char* path);
 
 	private:
-		std::vector<AudioAsset> audioAssets_; // All audio clips currently loaded.
+		std::unordered_map<std::string, std::shared_ptr<const AudioAsset>> wavAssets_; // Clips loaded from disk, by path.
+		std::vector<std::shared_ptr<const AudioAsset>> audioAssets_; // Clips created by the user.
 	};
 }
\ No newline at end of file
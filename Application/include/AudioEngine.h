@@ -1,16 +1,24 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
 #include <functional>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
 
 #include <portaudio.h>
 
+#include "MySTFT.h"
+#include "MyConvolution.h"
+#include "MySpscRing.h"
+#include "AssetManager.h"
+
 namespace MyApp
 {
-	class AssetManager;
-
-	// Class representing a single instance of a sound. It's lifetime is managed by the AudioEngine.
+	// Class representing a single instance of a sound. It's lifetime is managed by the AudioEngine, which refers to it through a SoundHandle.
+	// Outside of RenderMode::MainThread, its effects may only be changed directly until a command was first submitted for it, see AudioEngine::Submit().
 	class Sound
 	{
 	public:
@@ -19,25 +27,41 @@ namespace MyApp
 		/**
 		* Constructs a Sound instance.
 		* 
-		* @param bufferSize Size of the audio buffer used to service the audio (not the size of data!).
+		* @param bufferSize Size of the audio buffer used to service the audio (not the size of the asset!).
 		*/
 		Sound(const unsigned int bufferSize);
 
 		/**
-		* Plays the sound by setting currentBegin_ to 0 and currentEnd_ to bufferSize.
+		* Adds a post-processing effect to this Sound that will be applied before servicing the audio.
+		* 
+		* @param effect The callback that will apply the effect. Use a lambda. Signature should be: void fx(std::vector<float>& outBuffer).
 		*/
-		void Play();
+		void AddEffect(std::function<void(std::vector<float>&)> effect);
+
 		/**
-		* Stops the sound by setting currentBegin_ and currentEnd_ to a value > data.size().
+		* Adds a post-processing effect working on the spectrum of this Sound rather than on its samples. The Sound is streamed through an STFT, effect gets called on every spectral frame, and the frames are overlap-added back into audio by an ISTFT, all in constant memory.
+		* The effect delays the Sound by N - gcd(bufferSize, hop) samples, the smallest delay that always has a full buffer of output ready.
+		*
+		* @param effect The callback that will modify the bins 0 to N/2 of every frame in-place. Signature should be: void fx(std::vector<std::complex<float>>& spectrum).
+		* @param N Frame length of the STFT.
+		* @param hop Samples between the starts of two consecutive frames. The window must overlap-add to a non-zero sum at that hop, N/4 works for all of them.
+		* @param window Window applied to the frames.
 		*/
-		void Stop();
+		void AddSpectralEffect(std::function<void(std::vector<std::complex<float>>&)> effect, const unsigned int N, const unsigned int hop, const MyDFT::WindowType window = MyDFT::WindowType::Hann);
 
 		/**
-		* Adds a post-processing effect to this Sound that will be applied before servicing the audio.
-		* 
-		* @param effect The callback that will apply the effect. Use a lambda. Signature should be: void fx(std::vector<float>& outBuffer).
+		* Adds a post-processing effect convolving this Sound with an impulse response, e.g. a reverb or a long FIR filter. Runs in the frequency domain with a MyDFT::PartitionedConvolver of bufferSize blocks, so impulse responses of tens of thousands of taps fit in real time. Adds no latency.
+		*
+		* @param impulseResponse Taps of the filter, at the AudioEngine's sample rate.
 		*/
-		void AddEffect(std::function<void(std::vector<float>&)> effect);
+		void AddConvolutionEffect(const std::vector<float>& impulseResponse);
+
+		/**
+		* Adds a post-processing effect convolving this Sound with a long impulse response, several seconds of reverb for instance. Same result as AddConvolutionEffect() with the same zero latency, but through a MyDFT::NonUniformConvolver: the tail of the impulse response uses larger partitions, convolved on a worker thread of the effect's own. Safe in every RenderMode, the audio thread only wakes the worker up.
+		*
+		* @param impulseResponse Taps of the filter, at the AudioEngine's sample rate.
+		*/
+		void AddLongConvolutionEffect(const std::vector<float>& impulseResponse);
 
 		/**
 		* Returns a copy of fx_.
@@ -51,9 +75,26 @@ namespace MyApp
 		*/
 		void RemoveAllEffects();
 
+		/**
+		* Returns the samples the Sound plays, set by AudioEngine::CreateSound(). Only changed by the main thread, which may read it at any time.
+		*/
+		inline const std::shared_ptr<const AudioAsset>& GetAsset() const
+		{
+			return asset_;
+		}
+
+		// Playback state, changed by the thread mixing the audio and by SoundCommands. Outside of RenderMode::MainThread, the main thread may only read it until a command was first submitted for the Sound, see AudioEngine::Submit().
 		inline bool IsPlaying() const
 		{
-			return currentBegin_ < data.size();
+			return asset_ && currentBegin_ < asset_->data.size();
+		}
+		inline bool IsPaused() const
+		{
+			return paused_;
+		}
+		inline bool IsLooping() const
+		{
+			return looping_;
 		}
 
 		inline unsigned int GetCurrentBegin() const
@@ -65,15 +106,25 @@ namespace MyApp
 			return currentEnd_;
 		}
 
-		bool looping = true; // When set to true, the sound will start playing over once it has reached the end of data.
-		bool paused = false; // When set to true, suspends the update of currentBegin_ and currentEnd_ and prevents the Sound instance from servicing the audio.
-		std::vector<float> data; // Buffer containing a monophonic signal to play back. It's lifetime is managed by Sound.
-
-		const unsigned int bufferSize; // Size of the audio buffer used to service the audio (not the size of data).
+		const unsigned int bufferSize; // Size of the audio buffer used to service the audio (not the size of the asset).
 
 	private:
 		friend class AudioEngine;
 
+		/**
+		* Plays the sound by setting currentBegin_ to 0 and currentEnd_ to bufferSize. Called by the AudioEngine on SoundCommand::Type::Play, which also makes it an active voice.
+		*/
+		void Play();
+		/**
+		* Stops the sound by setting currentBegin_ and currentEnd_ to a value > asset_->data.size().
+		*/
+		void Stop();
+
+		/**
+		* Brings the Sound back to its state after construction and lets go of its asset and effects, for its slot of the AudioEngine to be reused.
+		*/
+		void Reset_();
+
 		/**
 		* Called at every AudioEngine update. Loads the next subsection of data into the provided buffers with fx_ applied.
 		* 
@@ -82,16 +133,80 @@ namespace MyApp
 		*/
 		void Process_(std::vector<float>& outLeft, std::vector<float>& outRight);
 
+		std::shared_ptr<const AudioAsset> asset_; // Monophonic signal to play back, shared with the AssetManager and the other Sounds playing it. Only set by AudioEngine::CreateSound() and Reset_(), on the main thread.
+		bool looping_ = true; // When set to true, the sound will start playing over once it has reached the end of data. Only set through SoundCommand::Type::SetLooping.
+		bool paused_ = false; // When set to true, suspends the update of currentBegin_ and currentEnd_ and prevents the Sound instance from servicing the audio. Only set through SoundCommand::Type::SetPaused, so that the Sound enters and leaves the active voices.
 		unsigned int currentBegin_ = (unsigned int)-1; // Start of the subsection of data currently being played back.
 		unsigned int currentEnd_ = (unsigned int)-1; // End of the subsection of data currently being played back.
 
+		bool submitted_ = false; // Whether a command was submitted for this Sound, handing it to the callback or the render thread. Only accessed by the main thread.
+
 		std::vector<std::function<void(std::vector<float>&)>> fx_; // List of callbacks used to add arbitrary effects to the current subsection of data before being returned in Process_().
 	};
 
+	// Generation-checked reference to a Sound of an AudioEngine. Safe to keep after the Sound got destroyed: the AudioEngine then ignores it, even once another Sound took its slot.
+	struct SoundHandle
+	{
+		static constexpr uint32_t NO_INDEX = (uint32_t)-1;
+
+		/**
+		* Returns whether the handle was returned by a successful CreateSound(). It may still refer to a Sound destroyed since, see AudioEngine::GetSound().
+		*/
+		inline bool IsSet() const
+		{
+			return index != NO_INDEX;
+		}
+
+		uint32_t index = NO_INDEX; // Slot of the Sound in the AudioEngine's pool.
+		uint32_t generation = 0; // Generation of the slot when the Sound was created.
+	};
+
+	// Change to a Sound sent to the thread mixing the audio, see AudioEngine::Submit().
+	struct SoundCommand
+	{
+		enum class Type : int
+		{
+			Play = 0, // Sound::Play().
+			Stop, // Sound::Stop().
+			SetPaused, // Pauses the Sound if value is true, resumes it otherwise.
+			SetLooping, // Makes the Sound loop if value is true.
+			SetEffects, // Replaces the effects of the Sound by effects.
+			Destroy // AudioEngine::DestroySound().
+		};
+
+		SoundCommand() = default;
+		/**
+		* Constructs any command but SetEffects.
+		*/
+		SoundCommand(const Type type, const SoundHandle sound, const bool value = false): type(type), sound(sound), value(value) {}
+		/**
+		* Constructs a SetEffects command.
+		*/
+		SoundCommand(const SoundHandle sound, std::vector<std::function<void(std::vector<float>&)>> effects): type(Type::SetEffects), sound(sound), effects(std::move(effects)) {}
+
+		Type type = Type::Play;
+		SoundHandle sound; // Sound the command applies to.
+		bool value = false; // New value of SetPaused and SetLooping.
+		std::vector<std::function<void(std::vector<float>&)>> effects; // New effects of SetEffects. Swapped with the Sound's, so that the old ones get freed by the thread submitting the next commands rather than by the audio thread.
+	};
+
+	// Thread on which AudioEngine mixes the Sounds.
+	enum class RenderMode : int
+	{
+		MainThread = 0, // ProcessAudio() mixes blocks ahead into a ring drained by the PortAudio callback. Audio only advances as often as ProcessAudio() gets called.
+		Callback, // The PortAudio callback mixes every buffer right when the device asks for it, latency is one buffer whatever the load of the main thread. Sounds are controlled through Submit() once playing.
+		RenderThread // A high-priority thread of the AudioEngine mixes blocks ahead into the ring, as many as the measured jitter of the callback calls for. Effects may take longer than a buffer now and then without the device running dry. Sounds are controlled through Submit() once playing.
+	};
+
 	// Class responsible for servicing the audio.
 	class AudioEngine
 	{
 	public:
+		static constexpr unsigned int COMMAND_QUEUE_SIZE = 256; // Commands that can wait for the next buffer in RenderMode::Callback and RenderMode::RenderThread.
+		static constexpr unsigned int DEFAULT_MAX_SOUNDS = 256; // Sounds that can exist at the same time unless the constructor is told otherwise.
+		static constexpr unsigned int RING_BLOCKS = 3; // Stereo blocks of bufferSize frames queued between ProcessAudio() and the playback device, at most RING_BLOCKS * bufferSize / sampleRate seconds of latency.
+		static constexpr unsigned int MIN_LOOKAHEAD_BLOCKS = 2; // Blocks the render thread keeps queued at least in RenderMode::RenderThread: the one the device is about to ask for and one in reserve.
+		static constexpr unsigned int MAX_LOOKAHEAD_BLOCKS = 16; // Blocks the render thread may queue at most in RenderMode::RenderThread, however large the jitter.
 
 		AudioEngine() = delete;
 		/**
@@ -99,62 +214,126 @@ namespace MyApp
 		* 
 		* @param sampleRate The sampling rate at which the audio data should be processed.
 		* @param bufferSize Size of the monophonic audio buffer used to service the audio.
+		* @param renderMode Thread on which the Sounds get mixed.
+		* @param maxSounds Capacity of the pool of Sounds, allocated upfront: a Sound costs its slot, the samples are shared, see CreateSound().
 		*/
-		AudioEngine(const unsigned int sampleRate, const unsigned int bufferSize);
+		AudioEngine(const unsigned int sampleRate, const unsigned int bufferSize, const RenderMode renderMode = RenderMode::MainThread, const unsigned int maxSounds = DEFAULT_MAX_SOUNDS);
 		~AudioEngine();
 
 		/**
-		* Creates an instance of a Sound and returns a pointer to it. The instance of the AudioEngine on which this method is called is responsible for this Sound's lifetime.
+		* Creates an instance of a Sound in a free slot of the pool and returns a handle to it. The instance of the AudioEngine on which this method is called is responsible for this Sound's lifetime.
+		* The Sound shares the asset, any number of Sounds can play the same clip for the cost of the Sounds alone.
+		*
+		* @param asset The monophonic signal to be played back by the new Sound.
+		* @return Handle to the newly created Sound, not set if maxSounds Sounds already exist.
+		*/
+		SoundHandle CreateSound(std::shared_ptr<const AudioAsset> asset);
+
+		/**
+		* Creates an instance of a Sound playing a wav file and returns a handle to it. The file is only loaded the first time, see AssetManager::LoadAudioAsset().
 		* 
 		* @param path Path to a .wav file containing the audio data to be played by the new Sound.
 		* @param assetManager Reference to the AssetManager that should be responsible for the lifetime of the loaded wav data.
-		* @return Pointer to the newly created Sound.
+		* @return Handle to the newly created Sound, not set if maxSounds Sounds already exist.
 		*/
-		Sound* CreateSound(const char* path, AssetManager& assetManager);
+		SoundHandle CreateSound(const char* path, AssetManager& assetManager);
 
 		/**
-		* Creates an instance of a Sound and returns a pointer to it. The instance of the AudioEngine on which this method is called is responsible for this Sound's lifetime.
+		* Creates an instance of a Sound playing a copy of a signal and returns a handle to it. To play the same signal several times, make an AudioAsset of it once with AssetManager::CreateAudioAsset() instead.
 		*
 		* @param data Reference to the data of a monophonic audio signal that should be copied and played back by the new Sound.
-		* @return Pointer to the newly created Sound.
+		* @return Handle to the newly created Sound, not set if maxSounds Sounds already exist.
+		*/
+		SoundHandle CreateSound(const std::vector<float>& data);
+
+		/**
+		* Creates an instance of a Sound playing a signal without copying it and returns a handle to it.
+		*
+		* @param data Monophonic audio signal to be moved from and played back by the new Sound.
+		* @return Handle to the newly created Sound, not set if maxSounds Sounds already exist.
+		*/
+		SoundHandle CreateSound(std::vector<float>&& data);
+
+		/**
+		* Creates an instance of a Sound from an existing Sound and returns a handle to it. The new Sound shares the asset of the other one.
+		*
+		* @param other Handle to another existing Sound that should be copied from.
+		* @return Handle to the newly created Sound, not set if other was destroyed or maxSounds Sounds already exist.
+		*/
+		SoundHandle DuplicateSound(const SoundHandle other);
+
+		/**
+		* Returns the Sound a handle refers to, for the main thread to set it up: effects. See Submit() for when it may still be changed directly.
+		*
+		* @param handle Handle returned by CreateSound() or DuplicateSound().
+		* @return The Sound, nullptr if it was destroyed.
 		*/
-		Sound* CreateSound(const std::vector<float>& data);
+		Sound* GetSound(const SoundHandle handle);
 
 		/**
-		* Creates an instance of a Sound from an existing Sound and returns a pointer to it. The instance of the AudioEngine on which this method is called is responsible for this Sound's lifetime.
+		* Destroys a Sound in O(1). Its handles become stale right away, its slot gets reused once the thread mixing the audio has let go of it.
 		*
-		* @param other Reference to another existing Sound that should be copied from.
-		* @return Pointer to the newly created Sound.
+		* @param handle Handle of the Sound. Ignored if it was already destroyed.
 		*/
-		Sound* DuplicateSound(const Sound& other);
+		void DestroySound(const SoundHandle handle);
 
 		/**
-		* Calls Stop() on all Sounds in sounds_.
+		* Changes a Sound from the main thread. In RenderMode::MainThread the command is applied right away. Otherwise it goes through a lock-free queue and gets applied by the callback or the render thread before it mixes its next buffer, commands submitted together landing on the same buffer. The render thread mixes ahead, so its commands are heard GetLookahead() buffers later.
+		* Outside of RenderMode::MainThread, a Sound belongs to the main thread, which may change it directly through GetSound(), until a command is first submitted for it. From then on the callback or the render thread mixes it and only commands may change it.
+		* When nothing mixes the audio outside of the main thread, e.g. the stream couldn't start or the device stopped in RenderMode::Callback, the queue and the command are applied right away instead.
+		* Never waits: the queue is full when more than COMMAND_QUEUE_SIZE commands get submitted within one buffer, the command can then be submitted again once the next buffer was mixed.
+		*
+		* @param command The command. Its effects are moved from only if it was accepted.
+		* @return False if the Sound of the command was destroyed or the queue is full, the command is then dropped.
+		*/
+		bool Submit(SoundCommand&& command);
+
+		/**
+		* Stops all the Sounds. Waits for room in the command queue if needed, as long as the audio is being mixed.
 		*/
 		void StopAll();
 
 		/**
-		* Destroys all sounds_ and clears the sounds_ vector.
+		* Destroys all the Sounds, see DestroySound(). Waits for room in the command queue if needed, as long as the audio is being mixed.
 		*/
 		void DestroyAll();
 
 		/**
-		* To be called by the user at a rate of roughly samplingRate / bufferSize times per second. Processes all sounds to the backBuffer_.
+		* In RenderMode::MainThread, to be called by the user at a rate of at least samplingRate / bufferSize times per second. Processes the active voices into every free block of ring_, does nothing if the ring is full.
+		* Does nothing in the other modes, the Sounds get mixed without it.
 		*/
 		void ProcessAudio();
 
+		/**
+		* Returns the number of device buffers played as silence so far because no block was ready: ProcessAudio() wasn't called often enough or the render thread fell behind, or the host API reported an output underflow. Can be called from any thread.
+		*/
+		uint64_t GetUnderrunCount() const;
+
+		/**
+		* Returns the number of device buffers the host API reported as discarded for lack of room (output overflow) so far. Can be called from any thread.
+		*/
+		uint64_t GetOverrunCount() const;
+
+		/**
+		* Returns the number of blocks the render thread currently keeps queued in RenderMode::RenderThread, between MIN_LOOKAHEAD_BLOCKS and MAX_LOOKAHEAD_BLOCKS, 0 in the other modes. Can be called from any thread.
+		*/
+		unsigned int GetLookahead() const;
+
 		const unsigned int sampleRate; // Sampling rate at which the audio should be serviced.
 		const unsigned int bufferSize; // The size of the audio buffer used to service the audio.
+		const RenderMode renderMode; // Thread on which the Sounds get mixed.
+		const unsigned int maxSounds; // Sounds that can exist at the same time, preallocated.
 
 	private:
 		/**
-		* Method called asynchronously by PortAudio at roughly samplingRate / bufferSize times per second. Swaps the frontBuffer and backBuffer and copies the contents of frontBuffer to the audiobuffer to be sent to the playback device.
+		* Method called asynchronously by PortAudio at roughly samplingRate / bufferSize times per second. Wait-free: takes no lock and doesn't allocate, effects aside.
+		* In RenderMode::MainThread and RenderMode::RenderThread, copies the oldest block of ring_ to the audiobuffer to be sent to the playback device, or silence if there is none. In RenderMode::Callback, applies the submitted commands and mixes the next buffer directly.
 		* 
 		* @param input Unused. Pointer to an input device's audio buffer.
 		* @param output Buffer to be sent for playback by the playback device.
 		* @param frameCount Unused. PortAudio's stuff.
 		* @param timeInfo Unused. PortAudio's stuff.
-		* @param statusFlags Unused. PortAudio's stuff.
+		* @param statusFlags Underflow and overflow flags raised by the host API, counted in underruns_ and overruns_.
 		* @param userData Pointer to the AudioEngine used to service the audio (this).
 		* @return PortAudio's status code. Returns 0 if all went well, an error code otherwise.
 		*/
@@ -164,14 +343,85 @@ namespace MyApp
 								 PaStreamCallbackFlags statusFlags,
 								 void* userData);
 
-		std::vector<float> frontBuffer_ = std::vector<float>(2 * (size_t)bufferSize, 0.0f); // Stereo buffer containing the processed audio data for the next playback device servicing.
-		std::vector<float> backBuffer_ = std::vector<float>(2 * (size_t)bufferSize, 0.0f); // Stereo buffer containing the not-yet-processed audio data being worked upon currently.
-		std::vector<std::function<void(std::vector<float>&)>> postProcessFx_; // List of global sound effects to apply to the frontBuffer before sending it over for playback. Currently unsused.
+		/**
+		* Loop of the render thread in RenderMode::RenderThread. Applies the submitted commands and keeps lookahead_ blocks queued in ring_, until stopRenderThread_ gets set.
+		*/
+		void RenderLoop_();
 
-		PaStream* stream_ = nullptr; // PortAudio's stream to playback device.
-		std::vector<Sound> sounds_; // List of Sounds managed by this AudioEngine.
+		/**
+		* Returns whether a thread other than the main one applies the commands and mixes the audio: the render thread, or the callback of an active stream.
+		*/
+		bool IsMixing_() const;
+
+		/**
+		* Submits a command, waiting for room in the queue while the audio is being mixed. Main thread.
+		*/
+		void SubmitWaiting_(SoundCommand&& command);
+
+		/**
+		* Applies the submitted commands. Called by the callback or the render thread before mixing, or by the main thread when nothing else mixes.
+		*/
+		void ApplyCommands_();
 
-		std::mutex m_; // Mutex used to synchronize the PortAudio's servicing thread to the SoundEngine's rendering thread. TODO: there should be two mutexes. TODO: make this class into an actual 2 layers deep pipeline rather than being a linear process with extra steps.
-		bool processNextBuffer_ = true; // Mutex protected boolean used to tell whether the AudioEngine should be processing the next set of audio data.
+		/**
+		* Applies a command to its Sound on the thread mixing the audio.
+		*/
+		void Apply_(SoundCommand& command);
+
+		/**
+		* Adds a voice to activeVoices_ if its Sound is playing and not paused. Thread mixing the audio.
+		*/
+		void Activate_(const uint32_t index);
+
+		/**
+		* Removes a voice from activeVoices_ if it's in it, in O(1). Thread mixing the audio.
+		*/
+		void Deactivate_(const uint32_t index);
+
+		/**
+		* Resets the Sounds of the voices released by the thread mixing the audio and adds them to freeVoices_. Main thread.
+		*/
+		void CollectReleasedVoices_();
+
+		/**
+		* Mixes the next bufferSize frames of the active voices into a stereo block, then applies postProcessFx_. Voices that stopped playing get deactivated.
+		*/
+		void Mix_(std::vector<float>& block);
+
+		static constexpr uint32_t NOT_ACTIVE = (uint32_t)-1;
+
+		// Slot of the Sound pool.
+		struct Voice
+		{
+			explicit Voice(const unsigned int bufferSize): sound(bufferSize) {}
+
+			Sound sound;
+			uint32_t generation = 0; // Incremented when the Sound gets destroyed, so that its handles don't match anymore. Main thread.
+			bool alive = false; // Whether the slot holds a Sound. Main thread.
+			uint32_t activePosition = NOT_ACTIVE; // Index in activeVoices_, or NOT_ACTIVE. Thread mixing the audio.
+		};
+
+		MyUtils::SpscRing<std::vector<float>> ring_ = MyUtils::SpscRing<std::vector<float>>((renderMode == RenderMode::RenderThread) ? MAX_LOOKAHEAD_BLOCKS : RING_BLOCKS, std::vector<float>(2 * (size_t)bufferSize, 0.0f)); // Interleaved stereo blocks processed by ProcessAudio() or the render thread (producer) and waiting to be played by ServiceAudio_() (consumer).
+		std::atomic<uint64_t> underruns_ = 0; // See GetUnderrunCount(). Written by the PortAudio thread only.
+		std::atomic<uint64_t> overruns_ = 0; // See GetOverrunCount(). Written by the PortAudio thread only.
+
+		std::vector<float> left_ = std::vector<float>(bufferSize); // Scratch buffers of the thread mixing the audio.
+		std::vector<float> right_ = std::vector<float>(bufferSize);
+		std::vector<float> stereo_ = std::vector<float>(2 * (size_t)bufferSize);
+		std::vector<float> callbackBlock_ = std::vector<float>(2 * (size_t)bufferSize); // Block mixed by the callback in RenderMode::Callback.
+		MyUtils::SpscRing<SoundCommand> commands_ = MyUtils::SpscRing<SoundCommand>(COMMAND_QUEUE_SIZE); // Commands waiting for the callback or the render thread.
+		std::vector<uint32_t> activeVoices_; // Voices playing and not paused, the only ones mixed. Preallocated to maxSounds. Thread mixing the audio.
+		std::vector<uint32_t> freeVoices_; // Slots without a Sound, used last first. Preallocated to maxSounds. Main thread.
+		MyUtils::SpscRing<uint32_t> releasedVoices_; // Slots of destroyed Sounds the thread mixing the audio let go of, on their way back to freeVoices_. maxSounds slots.
+		std::vector<std::function<void(std::vector<float>&)>> postProcessFx_; // List of global sound effects to apply to every block before sending it over for playback. Currently unsused.
+
+		std::thread renderThread_; // Mixes ahead in RenderMode::RenderThread.
+		std::atomic<bool> stopRenderThread_ = false;
+		std::atomic<unsigned int> lookahead_ = 0; // Blocks the render thread keeps queued, see GetLookahead().
+		std::atomic<double> callbackJitter_ = 0.0; // Largest recent deviation of the time between two callbacks from a buffer's duration, in seconds. Decays slowly, jumps by a buffer's duration on an underrun. Written by the PortAudio thread only.
+		std::chrono::steady_clock::time_point lastCallback_; // Time of the previous callback. Only accessed by the PortAudio thread.
+
+		PaStream* stream_ = nullptr; // PortAudio's stream to playback device.
+		std::vector<Voice> voices_; // Pool of the Sounds managed by this AudioEngine, maxSounds slots allocated upfront so that Sounds never move.
 	};
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <algorithm>
 
 #include "Application.h"
+#include "MyDFT.h"
 
 // Literals to configure the demo.
 static constexpr const size_t SINE_SAMPLE_RATE = 8000; // Length of the signals. Corresponds to N (for time-domain signals) and K (for frequency-domain signals).
@@ -134,8 +135,9 @@ void GenerateSignals()
 	synthesizedFreqDomain[SINE_FREQ] = std::complex<float>(std::cosf(ANGLE_IN_RADS) * SYNTHESIZED_COMPLEX_MAGNITUDE, std::sinf(ANGLE_IN_RADS) * SYNTHESIZED_COMPLEX_MAGNITUDE);
 	synthesizedFreqDomain[SINE_SAMPLE_RATE - SINE_FREQ] = std::complex<float>(-std::cosf(ANGLE_IN_RADS) * SYNTHESIZED_COMPLEX_MAGNITUDE, -std::sinf(ANGLE_IN_RADS) * SYNTHESIZED_COMPLEX_MAGNITUDE);
 
-	// Compute the DFT's and IDFT's of the generated / synthesized signals.
-	DFT(generatedFreqDomain, generatedTimeDomain, SINE_SAMPLE_RATE);
-	IDFT(generatedTimeDomainFromDFT, generatedFreqDomain, SINE_SAMPLE_RATE);
-	IDFT(synthesizedTimeDomainFromDFT, synthesizedFreqDomain, SINE_SAMPLE_RATE);
+	// Compute the DFT's and IDFT's of the generated / synthesized signals. The DFT() and IDFT() above are the textbook versions, MyDFT's dispatch to an FFT which gives the same bins without the 64M trigonometric calls of the double loop.
+	MyDFT::DFT(generatedFreqDomain, generatedTimeDomain, SINE_SAMPLE_RATE);
+	MyDFT::IDFT(generatedTimeDomainFromDFT, generatedFreqDomain, SINE_SAMPLE_RATE);
+	// Only two bins of the synthesized spectrum are non-zero, a pair of oscillators rebuilds the tone in O(2*N) where the IDFT would transform all 8000 bins.
+	MyDFT::IDFT(synthesizedTimeDomainFromDFT, MyDFT::MakeSparseSpectrum(synthesizedFreqDomain), SINE_SAMPLE_RATE);
 }
\ No newline at end of file
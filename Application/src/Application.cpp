@@ -2,6 +2,8 @@
 
 #include <easy/profiler.h>
 
+#include "MyPlanner.h"
+
 MyApp::Application::Application(const unsigned int displaySize, const unsigned int sampleRate, const unsigned int bufferSize): sdl_(SdlManager(displaySize)), audioEngine_(AudioEngine(sampleRate, bufferSize)) {}
 
 void MyApp::Application::Run(const std::vector<float>& generatedTimeDomain, const std::vector<float>& generatedTimeDomainFromDFT, const std::vector<float>& synthesizedTimeDomainFromDFT,
@@ -34,6 +36,10 @@ void MyApp::Application::Run(const std::vector<float>& generatedTimeDomain, cons
 			Callback_ResetTransformations_();
 		});
 
+	// Let MyDFT measure the fastest decomposition of every FFT length it meets, reusing the measurements of previous runs. Only lengths never seen before cost tens of milliseconds, once.
+	MyDFT::LoadWisdom();
+	MyDFT::SetPlannerMode(MyDFT::PlannerMode::Measure);
+
 	OnStart(); // Call back user startup code.
 
 	// Write time-domain signals to disk. Useful for checking if the audio artifacts come from the signal itself or from the hardware's processing.
@@ -60,19 +66,25 @@ void MyApp::Application::Run(const std::vector<float>& generatedTimeDomain, cons
 		throw std::runtime_error(std::string("Couldn't write txt to file."));
 	}
 
+	generatedAsset_ = assetManager_.CreateAudioAsset(generatedTimeDomain);
+	generatedFromDFTAsset_ = assetManager_.CreateAudioAsset(generatedTimeDomainFromDFT);
+	synthesizedFromDFTAsset_ = assetManager_.CreateAudioAsset(synthesizedTimeDomainFromDFT);
+
 	// Run program without sleeping.
 	bool shutdown = false;
 	while (!shutdown)
 	{
 		EASY_BLOCK("Application's update");
 		shutdown = sdl_.Update(); // Poll and process window and input events. Render and update display.
-		audioEngine_.ProcessAudio(); // Process the audio of all Sounds to the audio back buffer if necessary.
+		audioEngine_.ProcessAudio(); // Process the audio of all Sounds into the free blocks of the audio ring, if any.
 		OnUpdate(); // Call user update code.
 		UpdateToDisplayAndToPlay_(generatedTimeDomain, generatedTimeDomainFromDFT, synthesizedTimeDomainFromDFT, generatedFreqDomain, synthesizedFreqDomain);
 	}
 
 	OnShutdown(); // Call user shutdown code.
 
+	MyDFT::SaveWisdom(); // Not critical, the next run measures again if it fails.
+
 	// Output profiling file.
 #if BUILD_WITH_EASY_PROFILER
 	const auto success = profiler::dumpBlocksToFile((std::string(APPLICATION_PROFILER_OUTPUTS_DIR) + "session.prof").c_str());
@@ -279,6 +291,8 @@ void MyApp::Application::Callback_RenderImgui_()
 
 	ImGui::Text("Left mouse button: rotate, right mouse button: scale,\nmouse wheel: scroll through the signal, R: reset the view.\n");
 
+	ImGui::Text("Audio underruns: %llu, overruns: %llu", (unsigned long long)audioEngine_.GetUnderrunCount(), (unsigned long long)audioEngine_.GetOverrunCount());
+
 	ImGui::ListBox("Sound to play", (int*)&toPlay, soundNames, 4);
 
 	bool updateDisplayedWaveform = false;
@@ -316,20 +330,20 @@ void MyApp::Application::UpdateToDisplayAndToPlay_(const std::vector<float>& gen
 			break;
 		case SoundToPlay::Generated:
 		{
-			MyApp::Sound* generatedSound = audioEngine_.CreateSound(generatedTimeDomain);
-			generatedSound->Play();
+			const MyApp::SoundHandle generatedSound = audioEngine_.CreateSound(generatedAsset_);
+			audioEngine_.Submit({ SoundCommand::Type::Play, generatedSound });
 		}
 		break;
 		case SoundToPlay::GeneratedFromDFT:
 		{
-			MyApp::Sound* generatedSoundFromDFT = audioEngine_.CreateSound(generatedTimeDomainFromDFT);
-			generatedSoundFromDFT->Play();
+			const MyApp::SoundHandle generatedSoundFromDFT = audioEngine_.CreateSound(generatedFromDFTAsset_);
+			audioEngine_.Submit({ SoundCommand::Type::Play, generatedSoundFromDFT });
 		}
 		break;
 		case SoundToPlay::Synthesized:
 		{
-			MyApp::Sound* synthesizedSoundFromDFT = audioEngine_.CreateSound(synthesizedTimeDomainFromDFT);
-			synthesizedSoundFromDFT->Play();
+			const MyApp::SoundHandle synthesizedSoundFromDFT = audioEngine_.CreateSound(synthesizedFromDFTAsset_);
+			audioEngine_.Submit({ SoundCommand::Type::Play, synthesizedSoundFromDFT });
 		}
 		break;
 		default:
@@ -1,5 +1,6 @@
 #include "AssetManager.h"
 
+#include <algorithm>
 #include <fstream>
 #include <cstdlib>
 
@@ -7,6 +8,39 @@
 #include "dr_wav.h"
 
 MyApp::AudioAsset::AudioAsset(const std::vector<float>& data): data(data) {}
+MyApp::AudioAsset::AudioAsset(std::vector<float>&& data): data(std::move(data)) {}
+
+std::shared_ptr<const MyApp::AudioAsset> MyApp::AssetManager::LoadAudioAsset(const char* path)
+{
+	auto& asset = wavAssets_[path];
+	if (!asset)
+	{
+		unsigned int nrOfChannels, sampleRate;
+		asset = std::make_shared<const AudioAsset>(LoadWav(path, nrOfChannels, sampleRate));
+	}
+	return asset;
+}
+
+std::shared_ptr<const MyApp::AudioAsset> MyApp::AssetManager::CreateAudioAsset(const std::vector<float>& data)
+{
+	audioAssets_.push_back(std::make_shared<const AudioAsset>(data));
+	return audioAssets_.back();
+}
+std::shared_ptr<const MyApp::AudioAsset> MyApp::AssetManager::CreateAudioAsset(std::vector<float>&& data)
+{
+	audioAssets_.push_back(std::make_shared<const AudioAsset>(std::move(data)));
+	return audioAssets_.back();
+}
+
+void MyApp::AssetManager::ReleaseUnusedAssets()
+{
+	for (auto it = wavAssets_.begin(); it != wavAssets_.end();)
+	{
+		if (it->second.use_count() <= 1) it = wavAssets_.erase(it); // Null if the file failed to load.
+		else ++it;
+	}
+	audioAssets_.erase(std::remove_if(audioAssets_.begin(), audioAssets_.end(), [](const std::shared_ptr<const AudioAsset>& asset) { return asset.use_count() == 1; }), audioAssets_.end());
+}
 
 std::vector<float> MyApp::AssetManager::LoadWav(const char* path, unsigned int& nrOfChannels, unsigned int& sampleRate)
 {
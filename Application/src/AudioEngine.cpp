@@ -1,14 +1,44 @@
 #include "AudioEngine.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <thread>
+#include <memory>
+#include <numeric>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include <easy/profiler.h>
 
-#include "AssetManager.h"
 #include "MyUtils.h"
 
+// Asks the OS to schedule the calling thread ahead of the others. Real-time scheduling usually needs privileges on POSIX systems, the thread keeps its priority if it's denied.
+static void RaiseThreadPriority()
+{
+#if defined(_WIN32)
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+	sched_param param{};
+	param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1; // Just below the audio callback, if it runs as SCHED_FIFO too.
+	pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
+
 void MyApp::Sound::Play()
 {
 	currentBegin_ = 0;
@@ -20,16 +50,95 @@ void MyApp::Sound::Stop()
 	currentEnd_ = (unsigned int)-1;
 }
 
+void MyApp::Sound::Reset_()
+{
+	Stop();
+	looping_ = true;
+	paused_ = false;
+	asset_.reset();
+	std::vector<std::function<void(std::vector<float>&)>>().swap(fx_);
+	submitted_ = false;
+}
+
 void MyApp::Sound::AddEffect(std::function<void(std::vector<float>&)> effect)
 {
+	assert(!submitted_ && "The effects of a submitted Sound belong to the thread mixing the audio, replace them with SoundCommand::Type::SetEffects.");
 	fx_.push_back(effect);
 }
+void MyApp::Sound::AddSpectralEffect(std::function<void(std::vector<std::complex<float>>&)> effect, const unsigned int N, const unsigned int hop, const MyDFT::WindowType window)
+{
+	assert(!submitted_ && "The effects of a submitted Sound belong to the thread mixing the audio, replace them with SoundCommand::Type::SetEffects.");
+	// State shared by the copies of the callback. Samples leave the ISTFT hop at a time but the Sound needs them bufferSize at a time, the delay line in between is primed with just enough zeros to never run dry.
+	struct SpectralEffect
+	{
+		SpectralEffect(std::function<void(std::vector<std::complex<float>>&)> effect, const unsigned int N, const unsigned int hop, const MyDFT::WindowType window, const unsigned int bufferSize):
+			effect(std::move(effect)), stft(N, hop, window), istft(N, hop, window), spectrum(N / 2 + 1), delay((size_t)N + bufferSize, 0.0f), count(N - std::gcd(bufferSize, hop))
+		{
+			// Built once here rather than at every buffer, so that servicing the audio doesn't allocate.
+			onSamples = [this](const float* samples, const size_t newSamples)
+			{
+				assert(count + newSamples <= delay.size() && "Spectral effect delay line overrun.");
+				for (size_t i = 0; i < newSamples; ++i)
+				{
+					delay[(readPos + count + i) % delay.size()] = samples[i];
+				}
+				count += newSamples;
+			};
+			onFrame = [this](const std::vector<std::complex<float>>& frame, const size_t)
+			{
+				std::copy(frame.begin(), frame.end(), spectrum.begin());
+				this->effect(spectrum);
+				istft.PushFrame(spectrum, onSamples);
+			};
+		}
+
+		void Process(std::vector<float>& buffer)
+		{
+			stft.Push(buffer, onFrame);
+
+			assert(count >= buffer.size() && "Spectral effect delay line underrun.");
+			for (size_t i = 0; i < buffer.size(); ++i)
+			{
+				buffer[i] = delay[(readPos + i) % delay.size()];
+			}
+			readPos = (readPos + buffer.size()) % delay.size();
+			count -= buffer.size();
+		}
+
+		std::function<void(std::vector<std::complex<float>>&)> effect;
+		MyDFT::STFT stft;
+		MyDFT::ISTFT istft;
+		MyDFT::STFT::FrameCallback onFrame;
+		MyDFT::ISTFT::SampleCallback onSamples;
+		std::vector<std::complex<float>> spectrum; // Frame handed to effect.
+		std::vector<float> delay; // Ring of processed samples not yet played.
+		size_t readPos = 0;
+		size_t count; // Samples in delay.
+	};
+	auto state = std::make_shared<SpectralEffect>(std::move(effect), N, hop, window, bufferSize);
+
+	fx_.push_back([state](std::vector<float>& buffer) { state->Process(buffer); });
+}
+void MyApp::Sound::AddConvolutionEffect(const std::vector<float>& impulseResponse)
+{
+	assert(!submitted_ && "The effects of a submitted Sound belong to the thread mixing the audio, replace them with SoundCommand::Type::SetEffects.");
+	auto convolver = std::make_shared<MyDFT::PartitionedConvolver>(impulseResponse, bufferSize); // Shared by the copies of the callback, it holds the history of the stream.
+	fx_.push_back([convolver](std::vector<float>& buffer) { convolver->Process(buffer); });
+}
+void MyApp::Sound::AddLongConvolutionEffect(const std::vector<float>& impulseResponse)
+{
+	assert(!submitted_ && "The effects of a submitted Sound belong to the thread mixing the audio, replace them with SoundCommand::Type::SetEffects.");
+	auto convolver = std::make_shared<MyDFT::NonUniformConvolver>(impulseResponse, bufferSize, true);
+	fx_.push_back([convolver](std::vector<float>& buffer) { convolver->Process(buffer); });
+}
 std::vector<std::function<void(std::vector<float>&)>> MyApp::Sound::GetEffectsCopy() const
 {
+	assert(!submitted_ && "The effects of a submitted Sound belong to the thread mixing the audio, replace them with SoundCommand::Type::SetEffects.");
 	return fx_;
 }
 void MyApp::Sound::RemoveAllEffects()
 {
+	assert(!submitted_ && "The effects of a submitted Sound belong to the thread mixing the audio, replace them with SoundCommand::Type::SetEffects.");
 	fx_.clear();
 }
 
@@ -41,8 +150,9 @@ void MyApp::Sound::Process_(std::vector<float>& outLeft, std::vector<float>& out
 
 	const bool playing = IsPlaying();
 
-	if (paused || !playing) return;
+	if (paused_ || !playing) return;
 
+	const std::vector<float>& data = asset_->data;
 	const unsigned int dataSize = (unsigned int)data.size();
 
 	std::fill(outLeft.begin(), outLeft.end(), 0.0f);
@@ -54,7 +164,7 @@ void MyApp::Sound::Process_(std::vector<float>& outLeft, std::vector<float>& out
 		{
 			outLeft[i - currentBegin_] = data[i];
 		}
-		if (looping)
+		if (looping_)
 		{
 			for (unsigned int i = 0; i < currentEnd_ + 1; ++i) // Read the start of the data into the remaining not yet updated part of the soundDataSubset_.
 			{
@@ -80,7 +190,7 @@ void MyApp::Sound::Process_(std::vector<float>& outLeft, std::vector<float>& out
 	std::copy(outLeft.begin(), outLeft.end(), outRight.begin());
 
 	// Update indices.
-	if (looping) // currentBegin_ can never reach data.size().
+	if (looping_) // currentBegin_ can never reach data.size().
 	{
 		// Update currentBegin_
 		if (currentEnd_ + 1 == dataSize) // If dataSize % bufferSize = 0, this can happen, wrap back to 0.
@@ -125,8 +235,21 @@ void MyApp::Sound::Process_(std::vector<float>& outLeft, std::vector<float>& out
 	}
 }
 
-MyApp::AudioEngine::AudioEngine(const unsigned int sampleRate, const unsigned int bufferSize): sampleRate(sampleRate), bufferSize(bufferSize)
+MyApp::AudioEngine::AudioEngine(const unsigned int sampleRate, const unsigned int bufferSize, const RenderMode renderMode, const unsigned int maxSounds):
+	sampleRate(sampleRate), bufferSize(bufferSize), renderMode(renderMode), maxSounds(maxSounds), releasedVoices_(maxSounds)
 {
+	assert(maxSounds > 0 && "The pool needs at least one Sound.");
+
+	// The whole pool upfront, creating and destroying Sounds then never allocates nor moves them.
+	voices_.reserve(maxSounds);
+	freeVoices_.reserve(maxSounds);
+	activeVoices_.reserve(maxSounds);
+	for (uint32_t i = 0; i < maxSounds; ++i)
+	{
+		voices_.emplace_back(bufferSize);
+		freeVoices_.push_back(maxSounds - 1 - i); // Slot 0 first.
+	}
+
 	// Init portaudio.
 	auto err = Pa_Initialize();
 	if (err != paNoError) throw std::runtime_error(std::string("Failed to initialize PortAudio: ") + Pa_GetErrorText(err));
@@ -154,55 +277,127 @@ MyApp::AudioEngine::AudioEngine(const unsigned int sampleRate, const unsigned in
 	);
 	if (err != paNoError) throw std::runtime_error(std::string("Failed to open a stream to default playback device: ") + Pa_GetErrorText(err));
 
+	// Started first so that blocks are queued by the time the device asks for them.
+	if (renderMode == RenderMode::RenderThread) renderThread_ = std::thread(&AudioEngine::RenderLoop_, this);
+
 	err = Pa_StartStream(stream_);
-	if (err != paNoError) throw std::runtime_error(std::string("Failed to start stream to default playback device: ") + Pa_GetErrorText(err));
+	if (err != paNoError)
+	{
+		if (renderThread_.joinable())
+		{
+			stopRenderThread_.store(true, std::memory_order_release);
+			renderThread_.join();
+		}
+		throw std::runtime_error(std::string("Failed to start stream to default playback device: ") + Pa_GetErrorText(err));
+	}
 }
 
 MyApp::AudioEngine::~AudioEngine()
 {
 	auto err = Pa_StopStream(stream_);
 	if (err != paNoError) std::cerr << std::string("Error stopping stream to playback device: ") + Pa_GetErrorText(err) << std::endl;
+	if (renderThread_.joinable())
+	{
+		stopRenderThread_.store(true, std::memory_order_release);
+		renderThread_.join();
+	}
 	err = Pa_CloseStream(stream_);
 	if (err != paNoError) std::cerr << std::string("Error closing stream to playback device: ") + Pa_GetErrorText(err);
 	err = Pa_Terminate();
 	if (err != paNoError) std::cerr << std::string("Error shutting down PortAudio: ") + Pa_GetErrorText(err);
 }
 
-MyApp::Sound* MyApp::AudioEngine::CreateSound(const char* path, AssetManager& assetManager)
+MyApp::SoundHandle MyApp::AudioEngine::CreateSound(std::shared_ptr<const AudioAsset> asset)
 {
-	unsigned int nrOfChannels, sampleRate;
-	auto wavData = assetManager.LoadWav(path, nrOfChannels, sampleRate);
+	CollectReleasedVoices_();
+	if (freeVoices_.empty()) return SoundHandle();
 
-	sounds_.push_back(Sound(bufferSize));
-	sounds_.back().data = wavData;
+	const uint32_t index = freeVoices_.back();
+	freeVoices_.pop_back();
+	Voice& voice = voices_[index];
+	voice.alive = true;
+	voice.sound.asset_ = std::move(asset);
 
-	return &sounds_.back();
+	return { index, voice.generation };
+}
+MyApp::SoundHandle MyApp::AudioEngine::CreateSound(const char* path, AssetManager& assetManager)
+{
+	return CreateSound(assetManager.LoadAudioAsset(path));
 }
-MyApp::Sound* MyApp::AudioEngine::CreateSound(const std::vector<float>& data)
+MyApp::SoundHandle MyApp::AudioEngine::CreateSound(const std::vector<float>& data)
 {
-	sounds_.push_back(Sound(bufferSize));
-	sounds_.back().data = data;
+	return CreateSound(std::make_shared<const AudioAsset>(data));
+}
+MyApp::SoundHandle MyApp::AudioEngine::CreateSound(std::vector<float>&& data)
+{
+	return CreateSound(std::make_shared<const AudioAsset>(std::move(data)));
+}
+MyApp::SoundHandle MyApp::AudioEngine::DuplicateSound(const SoundHandle other)
+{
+	const Sound* sound = GetSound(other);
+	if (!sound) return SoundHandle();
+	return CreateSound(sound->asset_);
+}
 
-	return &sounds_.back();
+MyApp::Sound* MyApp::AudioEngine::GetSound(const SoundHandle handle)
+{
+	if (handle.index >= voices_.size()) return nullptr;
+	Voice& voice = voices_[handle.index];
+	return (voice.alive && voice.generation == handle.generation) ? &voice.sound : nullptr;
 }
-MyApp::Sound* MyApp::AudioEngine::DuplicateSound(const Sound& other)
+
+void MyApp::AudioEngine::DestroySound(const SoundHandle handle)
 {
-	sounds_.push_back(Sound(bufferSize));
-	sounds_.back().data = other.data;
-	return &sounds_.back();
+	Submit({ SoundCommand::Type::Destroy, handle });
+}
+
+bool MyApp::AudioEngine::Submit(SoundCommand&& command)
+{
+	Sound* sound = GetSound(command.sound);
+	if (!sound) return false;
+
+	const bool mixing = IsMixing_();
+	SoundCommand* slot = nullptr;
+	if (mixing && !(slot = commands_.BeginWrite())) return false; // Full, the whole queue gets applied every buffer.
+
+	if (command.type == SoundCommand::Type::Destroy)
+	{
+		// Stale from now on. The slot only becomes free once the thread mixing the audio released it, see CollectReleasedVoices_().
+		Voice& voice = voices_[command.sound.index];
+		voice.alive = false;
+		++voice.generation;
+	}
+
+	if (!mixing)
+	{
+		ApplyCommands_(); // Commands left over from before the stream stopped come first.
+		Apply_(command);
+		return true;
+	}
+
+	sound->submitted_ = true;
+	*slot = std::move(command); // Frees the effects a previous SetEffects left in the slot.
+	commands_.EndWrite();
+	return true;
 }
 
 void MyApp::AudioEngine::StopAll()
 {
-	for (size_t i = 0; i < sounds_.size(); ++i)
+	for (uint32_t i = 0; i < voices_.size(); ++i)
 	{
-		sounds_[i].Stop();
+		Voice& voice = voices_[i];
+		if (!voice.alive) continue;
+		if (renderMode != RenderMode::MainThread && !voice.sound.submitted_) voice.sound.Stop(); // Not mixed yet, the main thread still owns it.
+		else SubmitWaiting_({ SoundCommand::Type::Stop, { i, voice.generation } });
 	}
 }
 
 void MyApp::AudioEngine::DestroyAll() {
-	StopAll();
-	sounds_.clear();
+	for (uint32_t i = 0; i < voices_.size(); ++i)
+	{
+		if (voices_[i].alive) SubmitWaiting_({ SoundCommand::Type::Destroy, { i, voices_[i].generation } });
+	}
+	CollectReleasedVoices_(); // Frees the Sounds right away when nothing else mixes the audio.
 }
 
 int MyApp::AudioEngine::ServiceAudio_(const void* input, void* output,
@@ -214,11 +409,41 @@ int MyApp::AudioEngine::ServiceAudio_(const void* input, void* output,
 	EASY_BLOCK("ServiceAudio_()");
 
 	auto self = (MyApp::AudioEngine*)userData;
-	std::lock_guard<std::mutex> l(self->m_);
 
-	std::swap(self->frontBuffer_, self->backBuffer_);
-	std::memcpy(output, self->frontBuffer_.data(), sizeof(float) * self->frontBuffer_.size());
-	self->processNextBuffer_ = true;
+	if (statusFlags & paOutputUnderflow) self->underruns_.fetch_add(1, std::memory_order_relaxed);
+	if (statusFlags & paOutputOverflow) self->overruns_.fetch_add(1, std::memory_order_relaxed);
+
+	if (self->renderMode == RenderMode::Callback)
+	{
+		self->ApplyCommands_();
+		self->Mix_(self->callbackBlock_);
+		std::memcpy(output, self->callbackBlock_.data(), sizeof(float) * self->callbackBlock_.size());
+		return paContinue;
+	}
+
+	const double period = (double)self->bufferSize / (double)self->sampleRate;
+	if (self->renderMode == RenderMode::RenderThread)
+	{
+		// Peak deviation of the callback from its period, decaying by half in about 700 callbacks (a few seconds).
+		const auto now = std::chrono::steady_clock::now();
+		if (self->lastCallback_.time_since_epoch().count() != 0)
+		{
+			const double deviation = std::abs(std::chrono::duration<double>(now - self->lastCallback_).count() - period);
+			self->callbackJitter_.store(std::max(deviation, self->callbackJitter_.load(std::memory_order_relaxed) * 0.999), std::memory_order_relaxed);
+		}
+		self->lastCallback_ = now;
+	}
+
+	const std::vector<float>* block = self->ring_.BeginRead();
+	if (!block) // ProcessAudio() or the render thread fell behind, play silence rather than wait for it.
+	{
+		std::memset(output, 0, sizeof(float) * 2 * (size_t)self->bufferSize);
+		self->underruns_.fetch_add(1, std::memory_order_relaxed);
+		if (self->renderMode == RenderMode::RenderThread) self->callbackJitter_.store(self->callbackJitter_.load(std::memory_order_relaxed) + period, std::memory_order_relaxed); // One more block ahead.
+		return paContinue;
+	}
+	std::memcpy(output, block->data(), sizeof(float) * block->size());
+	self->ring_.EndRead();
 
 	return paContinue;
 }
@@ -226,36 +451,175 @@ void MyApp::AudioEngine::ProcessAudio()
 {
 	EASY_BLOCK("ProcessAudio()");
 
-	// Don't process unless the audio needs servicing. Acquire lock to check boolean. Note: I'm sure there's a better way to do this?
+	if (renderMode != RenderMode::MainThread) return;
+
+	// Fill every free block, the device drains them at its own pace.
+	std::vector<float>* block;
+	while ((block = ring_.BeginWrite()))
 	{
-		EASY_BLOCK("ProcessAudio(): checking bool");
-		std::lock_guard<std::mutex> l(m_);
-		if (!processNextBuffer_) return;
+		Mix_(*block);
+		ring_.EndWrite();
 	}
+}
 
-	static std::vector<float> left(bufferSize);
-	static std::vector<float> right(bufferSize);
-	static std::vector<float> stereoSignal(2 * (size_t)bufferSize);
-	static std::vector<float> processedBackbuffer(2 * (size_t)bufferSize);
+void MyApp::AudioEngine::RenderLoop_()
+{
+	RaiseThreadPriority();
 
-	std::fill(processedBackbuffer.begin(), processedBackbuffer.end(), 0.0f);
-	for (size_t i = 0; i < sounds_.size(); ++i)
+	const double period = (double)bufferSize / (double)sampleRate;
+	const auto sleep = std::chrono::duration<double>(period / 2.0); // Checks the ring twice per buffer.
+	double renderLateness = 0.0; // Peak time the thread took to render a block, or woke up late by, decaying like callbackJitter_.
+	while (!stopRenderThread_.load(std::memory_order_acquire))
 	{
-		sounds_[i].Process_(left, right);
-		MyUtils::InterleaveSignals(stereoSignal, left, right); // Note: pretty sure I can rearrange things to move this method out of the for loop.
-		MyUtils::SumSignals(processedBackbuffer, stereoSignal);
+		ApplyCommands_();
+
+		// One block for the device to take next, one in reserve, plus as many as the callback and this thread may be late by.
+		const double slack = callbackJitter_.load(std::memory_order_relaxed) + renderLateness;
+		const unsigned int lookahead = std::clamp(MIN_LOOKAHEAD_BLOCKS + (unsigned int)std::ceil(slack / period), MIN_LOOKAHEAD_BLOCKS, MAX_LOOKAHEAD_BLOCKS);
+		lookahead_.store(lookahead, std::memory_order_relaxed);
+
+		std::vector<float>* block;
+		while (ring_.GetCount() < lookahead && (block = ring_.BeginWrite()))
+		{
+			const auto start = std::chrono::steady_clock::now();
+			Mix_(*block);
+			ring_.EndWrite();
+			renderLateness = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), renderLateness * 0.999);
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		std::this_thread::sleep_for(sleep);
+		const double overslept = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - sleep.count();
+		renderLateness = std::max(overslept, renderLateness * 0.999);
 	}
+}
 
-	for (size_t i = 0; i < postProcessFx_.size(); ++i)
+bool MyApp::AudioEngine::IsMixing_() const
+{
+	if (renderMode == RenderMode::RenderThread) return renderThread_.joinable(); // Applies the commands whether the stream runs or not.
+	return renderMode == RenderMode::Callback && Pa_IsStreamActive(stream_) == 1;
+}
+
+void MyApp::AudioEngine::SubmitWaiting_(SoundCommand&& command)
+{
+	// Submit() applies the command itself if the stream stops meanwhile.
+	while (!Submit(std::move(command)) && GetSound(command.sound))
 	{
-		postProcessFx_[i](backBuffer_);
+		std::this_thread::yield();
 	}
+}
 
-	// Acquire lock and write to backbuffer.
+void MyApp::AudioEngine::ApplyCommands_()
+{
+	SoundCommand* command;
+	while ((command = commands_.BeginRead()))
 	{
-		EASY_BLOCK("ProcessAudio(): writing to backBuffer");
-		std::lock_guard<std::mutex> l(m_);
-		std::copy(processedBackbuffer.begin(), processedBackbuffer.end(), backBuffer_.begin());
-		processNextBuffer_ = false;
+		Apply_(*command);
+		commands_.EndRead();
+	}
+}
+
+void MyApp::AudioEngine::Apply_(SoundCommand& command)
+{
+	const uint32_t index = command.sound.index;
+	Sound& sound = voices_[index].sound;
+	switch (command.type)
+	{
+	case SoundCommand::Type::Play:
+		sound.Play();
+		Activate_(index);
+		break;
+	case SoundCommand::Type::Stop:
+		sound.Stop();
+		Deactivate_(index);
+		break;
+	case SoundCommand::Type::SetPaused:
+		sound.paused_ = command.value;
+		if (sound.paused_) Deactivate_(index);
+		else Activate_(index);
+		break;
+	case SoundCommand::Type::SetLooping:
+		sound.looping_ = command.value;
+		break;
+	case SoundCommand::Type::SetEffects:
+		std::swap(sound.fx_, command.effects);
+		break;
+	case SoundCommand::Type::Destroy:
+	{
+		Deactivate_(index);
+		uint32_t* released = releasedVoices_.BeginWrite();
+		assert(released && "More voices released than exist.");
+		*released = index;
+		releasedVoices_.EndWrite();
+	}
+	break;
+	default:
+		break;
 	}
-}
\ No newline at end of file
+}
+
+void MyApp::AudioEngine::Activate_(const uint32_t index)
+{
+	Voice& voice = voices_[index];
+	if (voice.activePosition != NOT_ACTIVE || voice.sound.paused_ || !voice.sound.IsPlaying()) return;
+	voice.activePosition = (uint32_t)activeVoices_.size();
+	activeVoices_.push_back(index); // Never allocates, reserved for every voice.
+}
+
+void MyApp::AudioEngine::Deactivate_(const uint32_t index)
+{
+	Voice& voice = voices_[index];
+	if (voice.activePosition == NOT_ACTIVE) return;
+	// The last active voice takes its place.
+	const uint32_t last = activeVoices_.back();
+	activeVoices_[voice.activePosition] = last;
+	voices_[last].activePosition = voice.activePosition;
+	activeVoices_.pop_back();
+	voice.activePosition = NOT_ACTIVE;
+}
+
+void MyApp::AudioEngine::CollectReleasedVoices_()
+{
+	uint32_t* index;
+	while ((index = releasedVoices_.BeginRead()))
+	{
+		voices_[*index].sound.Reset_();
+		freeVoices_.push_back(*index);
+		releasedVoices_.EndRead();
+	}
+}
+
+void MyApp::AudioEngine::Mix_(std::vector<float>& block)
+{
+	EASY_BLOCK("Mix_()");
+
+	std::fill(block.begin(), block.end(), 0.0f);
+	for (size_t i = activeVoices_.size(); i-- > 0;) // Backwards, deactivating a voice moves the last one, already mixed, to its place.
+	{
+		const uint32_t index = activeVoices_[i];
+		Sound& sound = voices_[index].sound;
+		sound.Process_(left_, right_);
+		MyUtils::InterleaveSignals(stereo_, left_, right_); // Note: pretty sure I can rearrange things to move this method out of the for loop.
+		MyUtils::SumSignals(block, stereo_);
+
+		if (!sound.IsPlaying()) Deactivate_(index); // Reached the end of its data without looping.
+	}
+
+	for (size_t i = 0; i < postProcessFx_.size(); ++i)
+	{
+		postProcessFx_[i](block);
+	}
+}
+
+uint64_t MyApp::AudioEngine::GetUnderrunCount() const
+{
+	return underruns_.load(std::memory_order_relaxed);
+}
+uint64_t MyApp::AudioEngine::GetOverrunCount() const
+{
+	return overruns_.load(std::memory_order_relaxed);
+}
+unsigned int MyApp::AudioEngine::GetLookahead() const
+{
+	return lookahead_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "MyPlanner.h"
+#include "MyThreadPool.h"
+
+// Throughput of the FFT engine as the length grows past the size of the last-level cache: the stages alone, and with the lengths that don't fit going through a FourStepFFT.
+// Usage: Benchmarks [maxLog2Length] [threadCount]. Defaults to 2^26 values and one thread per hardware thread.
+
+static constexpr unsigned int MIN_LOG2_LENGTH = 12;
+static constexpr double MIN_SECONDS = 0.2; // Shortest run per measurement, to average out the timer and the noise.
+
+/**
+* Times an engine, in seconds per transform: the fastest of 3 runs of at least MIN_SECONDS.
+*/
+static double Time(MyDFT::FFTEngine& engine, std::vector<float>& re, std::vector<float>& im, MyUtils::ThreadPool* pool)
+{
+	using Clock = std::chrono::steady_clock;
+
+	engine.TransformSplit(re.data(), im.data(), pool); // Warm up, and fault the pages of the scratch buffers in.
+	double best = 1e30;
+	for (int run = 0; run < 3; ++run)
+	{
+		size_t repetitions = 0;
+		const Clock::time_point start = Clock::now();
+		double seconds = 0.0;
+		do
+		{
+			engine.TransformSplit(re.data(), im.data(), pool);
+			++repetitions;
+			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		} while (seconds < MIN_SECONDS);
+		best = std::min(best, seconds / (double)repetitions);
+	}
+	return best;
+}
+
+int main(int argc, char** argv)
+{
+	const unsigned int maxLog2Length = (argc > 1) ? (unsigned int)std::atoi(argv[1]) : 26;
+	const unsigned int threadCount = (argc > 2) ? (unsigned int)std::atoi(argv[2]) : 0;
+	MyUtils::ThreadPool pool(threadCount);
+
+	// The usual rate of FFT benchmarks, 5 * N * log2(N) / t: flat when the transform is compute-bound, dropping once it's memory-bound.
+	std::printf("Kernels: %s, %u threads in the pool. Rates in GFlop/s.\n", MyDFT::Kernels::ToString(MyDFT::Kernels::GetKernels().instructionSet), pool.GetThreadCount() + 1);
+	std::printf("%10s %8s %12s %12s %12s %12s\n", "length", "MB", "stages", "four-step", "stages MT", "four-step MT");
+	for (unsigned int log2Length = MIN_LOG2_LENGTH; log2Length <= maxLog2Length; ++log2Length)
+	{
+		const unsigned int length = 1u << log2Length;
+		std::vector<float> re(length, 0.0f), im(length, 0.0f);
+
+		MyDFT::EngineConfig stagesConfig = MyDFT::EstimateEngine(length, MyDFT::Kernels::GetKernels().instructionSet);
+		stagesConfig.fourStep = false;
+		stagesConfig.radices = MyDFT::FFTEngine::Factorize(length);
+		MyDFT::EngineConfig fourStepConfig = stagesConfig;
+		fourStepConfig.fourStep = true;
+		fourStepConfig.radices.clear();
+
+		const double flops = 5.0 * (double)length * (double)log2Length * 1e-9;
+		double rates[4] = {};
+		{
+			MyDFT::FFTEngine engine(length, MyDFT::Direction::Forward, stagesConfig);
+			rates[0] = flops / Time(engine, re, im, nullptr);
+			rates[2] = flops / Time(engine, re, im, &pool);
+		}
+		{
+			MyDFT::FFTEngine engine(length, MyDFT::Direction::Forward, fourStepConfig);
+			rates[1] = flops / Time(engine, re, im, nullptr);
+			rates[3] = flops / Time(engine, re, im, &pool);
+		}
+		std::printf("%10u %8.1f %12.2f %12.2f %12.2f %12.2f\n", length, (double)length * 2.0 * sizeof(float) / (1024.0 * 1024.0), rates[0], rates[1], rates[2], rates[3]);
+	}
+	return 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include "MyFFTEngine.h"
+
+namespace MyDFT
+{
+	/**
+	* Chirp-z transform by Bluestein's algorithm: evaluates X[k] = sum_n(x[n] * e^(-i*n*(startAngle + k*stepAngle))) for k < K, K points of the z-transform evenly spaced on the unit circle, in O((N+K) log(N+K)).
+	* Writing n*k = (n^2 + k^2 - (k-n)^2) / 2 turns the sum into a convolution with the chirp e^(i*stepAngle*j^2/2), computed with FFTs of the smallest length L >= N+K-1 whose prime factors are all 2, 3 or 5, the lengths the engine has dedicated kernels for.
+	* With stepAngle = 2*PI/N that's an exact-length DFT for any N, primes included: FFTEngine uses it for lengths with a large prime factor. Any other step zooms on a band of the spectrum, see ZoomDFT().
+	* Not thread-safe, the transform owns its scratch buffers.
+	*/
+	class ChirpZ
+	{
+	public:
+		ChirpZ() = delete;
+		/**
+		* Constructs a ChirpZ. Computes the chirps and the transform of the convolution filter.
+		*
+		* @param N Number of input values.
+		* @param K Number of output points.
+		* @param startAngle Angle of the first point, in radians. 2*PI*f0/sampleRate for a frequency f0.
+		* @param stepAngle Angle between two consecutive points, in radians. Any value, negative ones go clockwise.
+		*/
+		ChirpZ(const unsigned int N, const unsigned int K, const double startAngle, const double stepAngle);
+
+		/**
+		* Evaluates the K points of a real-valued signal. Does not allocate.
+		*
+		* @param out Output points. Ensure out.size() is at least K before calling this method.
+		* @param x Input real-valued signal of size N.
+		* @param pool Optional thread pool to split the FFT stages across.
+		*/
+		void Execute(std::vector<std::complex<float>>& out, const std::vector<float>& x, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Evaluates the K points of a complex-valued signal in split format. Does not allocate. The input is read before the output gets written, so both may share buffers.
+		*
+		* @param outRe Real parts of the output, buffer of K floats.
+		* @param outIm Imaginary parts of the output, buffer of K floats.
+		* @param inRe Real parts of the input, buffer of N floats.
+		* @param inIm Imaginary parts of the input, buffer of N floats. nullptr for a real-valued input.
+		* @param pool Optional thread pool to split the FFT stages across.
+		*/
+		void ExecuteSplit(float* outRe, float* outIm, const float* inRe, const float* inIm, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Returns the smallest length of at least minLength whose prime factors are all 2, 3 or 5.
+		*/
+		static unsigned int SmoothLength(const unsigned int minLength);
+
+		const unsigned int N; // Number of input values.
+		const unsigned int K; // Number of output points.
+		const double startAngle; // Angle of point 0.
+		const double stepAngle; // Angle between consecutive points.
+
+	private:
+		FFTEngine forward_; // L-point engines of the convolution.
+		FFTEngine inverse_;
+		std::vector<float> inputChirpRe_; // e^(-i*(startAngle*n + stepAngle*n^2/2)) for n < N, split format.
+		std::vector<float> inputChirpIm_;
+		std::vector<float> outputChirpRe_; // e^(-i*stepAngle*k^2/2) for k < K, split format.
+		std::vector<float> outputChirpIm_;
+		std::vector<float> filterRe_; // Transform of the chirp e^(i*stepAngle*j^2/2) for j in (-N, K), wrapped around L and scaled by 1/L.
+		std::vector<float> filterIm_;
+		std::vector<float> workRe_; // Buffer of L values the convolution runs in.
+		std::vector<float> workIm_;
+	};
+
+	/**
+	* Evaluates the spectrum of a real-valued signal over a band [f0, f1] only, at any resolution, with a chirp-z transform. Costs O((N+K) log(N+K)) whatever the width of the band, where a DFT fine enough to get the same resolution would need a much longer zero-padded input.
+	* The transform is built on every call, keep a ChirpZ to evaluate the same band of many signals.
+	*
+	* @param out Output of the function, K points evenly spaced from f0 to f1 included: out[k] = sum_n(x[n] * e^(-i*2*PI*f*n/sampleRate)) with f = f0 + k*(f1-f0)/(K-1). Resized to K by the function.
+	* @param x Input real-valued signal.
+	* @param K Number of points of the band.
+	* @param f0 First frequency of the band.
+	* @param f1 Last frequency of the band, can be lower than f0.
+	* @param sampleRate Sampling rate of x, in the same unit as f0 and f1. Pass x.size() to give the band in (possibly fractional) bins.
+	*/
+	void ZoomDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int K, const double f0, const double f1, const double sampleRate);
+
+	/**
+	* Out-of-place version of ZoomDFT().
+	*
+	* @param x Input real-valued signal.
+	* @param K Number of points of the band.
+	* @param f0 First frequency of the band.
+	* @param f1 Last frequency of the band.
+	* @param sampleRate Sampling rate of x.
+	* @return K points evenly spaced from f0 to f1 included.
+	*/
+	std::vector<std::complex<float>> ZoomDFT(const std::vector<float>& x, const unsigned int K, const double f0, const double f1, const double sampleRate);
+}
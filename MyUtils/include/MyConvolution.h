@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <semaphore>
+
+#include "MyDFTPlan.h"
+
+namespace MyDFT
+{
+	/**
+	* Streaming FIR filter by uniformly-partitioned overlap-save convolution. The impulse response is cut into partitions of blockSize taps whose 2*blockSize-point spectra are computed once by the constructor.
+	* Every block of input costs one forward and one inverse FFT of 2*blockSize points plus one spectral multiply-accumulate per partition, against a frequency-domain delay line holding the spectra of the previous inputs. That's O(log(blockSize) + taps / blockSize) operations per sample instead of O(taps) for a time-domain convolution.
+	* The output of a block only depends on that block and the previous ones, so the filter adds no latency. Processing does not allocate.
+	*/
+	class PartitionedConvolver
+	{
+	public:
+		PartitionedConvolver() = delete;
+		/**
+		* Constructs a PartitionedConvolver. Transforms the partitions of the impulse response.
+		*
+		* @param impulseResponse Taps of the filter, any length.
+		* @param blockSize Number of samples per call to Process(). Typically the audio buffer size.
+		*/
+		PartitionedConvolver(const std::vector<float>& impulseResponse, const unsigned int blockSize);
+
+		/**
+		* Filters the next block of the stream in-place.
+		*
+		* @param block Buffer of blockSize samples.
+		*/
+		void Process(float* block);
+
+		/**
+		* Overload of Process() for a buffer of exactly blockSize samples.
+		*/
+		void Process(std::vector<float>& block);
+
+		/**
+		* Forgets the previous inputs, as if the stream started again.
+		*/
+		void Reset();
+
+		const unsigned int blockSize; // Samples per block, also the taps per partition.
+		const size_t partitionCount; // Number of partitions of the impulse response.
+
+	private:
+		Plan forward_; // 2*blockSize-point real-to-complex plan.
+		Plan inverse_; // 2*blockSize-point complex-to-real plan.
+		const Kernels::KernelTable& kernels_;
+		std::vector<float> input_; // Previous and current input blocks.
+		std::vector<float> output_; // Inverse transform of the accumulated spectrum, the last blockSize samples are the output.
+		std::vector<std::complex<float>> spectrum_; // Bins 0 to blockSize of the transforms.
+		std::vector<float> partitionsRe_; // Spectra of the impulse response partitions, blockSize+1 bins each, split format.
+		std::vector<float> partitionsIm_;
+		std::vector<float> delayLineRe_; // Spectra of the last partitionCount input blocks, ring of blockSize+1 bins each, split format.
+		std::vector<float> delayLineIm_;
+		std::vector<float> accumulatorRe_; // Sum of the spectral products.
+		std::vector<float> accumulatorIm_;
+		size_t delayLinePos_ = 0; // Slot of the newest input spectrum in the delay line.
+	};
+
+	/**
+	* Streaming FIR filter by non-uniformly partitioned convolution, for impulse responses of several seconds. Keeps the zero latency of a PartitionedConvolver of blockSize blocks but the work per sample grows with the log of the impulse response length rather than linearly.
+	* The head of the impulse response, up to 4*blockSize taps, goes through a PartitionedConvolver of blockSize blocks. The rest is cut in segments of partitions twice as large every time: segment s uses partitions of Bs = blockSize*2^s taps and starts at tap 2*Bs, so its output for a block of Bs inputs is only needed Bs samples after that block is complete.
+	* That slack lets each segment convolve a whole block in the background while the next one gets pushed, on a worker thread of the convolver if it has one. Without one, the convolutions run in the call completing their block, which is correct but makes the cost of the calls uneven.
+	* The worker is started by the constructor and woken through a semaphore, so Process() neither locks nor allocates: it's safe to call from a real-time audio callback.
+	*/
+	class NonUniformConvolver
+	{
+	public:
+		NonUniformConvolver() = delete;
+		NonUniformConvolver(const NonUniformConvolver&) = delete;
+		NonUniformConvolver& operator=(const NonUniformConvolver&) = delete;
+		/**
+		* Constructs a NonUniformConvolver. Transforms the partitions of every segment.
+		*
+		* @param impulseResponse Taps of the filter, any length.
+		* @param blockSize Number of samples per call to Process(). Typically the audio buffer size.
+		* @param background Whether the large partitions are convolved on a worker thread of the convolver, rather than in Process().
+		* @param maxPartitionSize Largest partition size, segments stop doubling there and the last one takes the rest of the impulse response. Rounded down to blockSize times a power of 2.
+		*/
+		NonUniformConvolver(const std::vector<float>& impulseResponse, const unsigned int blockSize, const bool background = false, const unsigned int maxPartitionSize = 8192);
+
+		/**
+		* Waits for the background convolutions still running and joins the worker.
+		*/
+		~NonUniformConvolver();
+
+		/**
+		* Filters the next block of the stream in-place. Blocks until the background convolutions whose output is due are done.
+		*
+		* @param block Buffer of blockSize samples.
+		*/
+		void Process(float* block);
+
+		/**
+		* Overload of Process() for a buffer of exactly blockSize samples.
+		*/
+		void Process(std::vector<float>& block);
+
+		/**
+		* Forgets the previous inputs, as if the stream started again.
+		*/
+		void Reset();
+
+		/**
+		* Returns the number of segments, the head included.
+		*/
+		size_t GetSegmentCount() const;
+
+		const unsigned int blockSize; // Samples per block.
+
+	private:
+		// Part of the impulse response convolved with partitions of a single size, larger than blockSize.
+		struct Segment
+		{
+			Segment(const std::vector<float>& impulseResponse, const unsigned int partitionSize);
+
+			PartitionedConvolver convolver;
+			std::vector<float> input; // Block being gathered from the stream.
+			std::vector<float> work; // Block being convolved in-place, by the background job if busy.
+			std::vector<float> ready; // Convolved block being added to the output.
+			std::atomic<bool> busy = false; // Whether work is handed to the worker, which clears it once convolved.
+		};
+
+		/**
+		* Waits for the worker to be done with segment.
+		*/
+		void Wait_(Segment& segment);
+
+		/**
+		* Loop of the worker thread. Convolves the busy segments, smallest partitions first as their output is due first, until stop_ gets set.
+		*/
+		void WorkerLoop_();
+
+		PartitionedConvolver head_; // First 4*blockSize taps.
+		std::vector<std::unique_ptr<Segment>> segments_;
+		std::vector<float> dry_; // Copy of the block being processed, head_ filters in-place.
+		size_t position_ = 0; // Number of samples processed, the phase of every segment's blocks.
+
+		std::counting_semaphore<> wake_{ 0 }; // Released once per segment handed to the worker.
+		std::atomic<bool> stop_ = false; // Set by the destructor to end WorkerLoop_().
+		std::thread worker_; // Not joinable without background. Declared last, so that it's started once everything it uses is constructed.
+	};
+}
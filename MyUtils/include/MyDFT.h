@@ -3,22 +3,30 @@
 #include <vector>
 #include <complex>
 
+#include "MyDFTPlan.h"
+
 namespace MyDFT
 {
 	/**
 	* Discrete Fourier Transform. Computes the frequency-domain representation of a time-domain signal. In-place version.
-	* 
+	* Dispatches to the FFT engine (see FFT()), which picks radix-4, radix-2 and mixed-radix stages by factorizing N. Use NaiveDFT() for a reference implementation.
+	* The real-valued input only halves the FFT for an even N, an odd N runs a full N-point complex FFT (see RealDFT()).
+	* The twiddle factors come from the calling thread's cached Plan (see GetPlan()), repeated calls with the same N and K do no trigonometry.
+	*
 	* @param out Output of the function, the frequency bins resulting from the DFT. Ensure out.size() is K before calling this function.
 	* @param x Input real-valued signal. x.size() defines N.
-	* @param K Number of frequency bins that constitute the out signal. Any value K < N results in spectral loss so for lossless transfomation use K = x.size().
+	* @param K Number of frequency bins that constitute the out signal. Any value K < N results in spectral loss so for lossless transfomation use K = x.size(). To compute a band of bins that doesn't start at 0 for less than a full FFT, see PrunedDFT().
 	*/
 	void DFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int K, const bool printProgress = true);
 
 	/**
 	* Discrete Fourier Transform. Computes the frequency-domain representation of a time-domain signal. Out-of-place version.
+	* Dispatches to the FFT engine (see FFT()), which picks radix-4, radix-2 and mixed-radix stages by factorizing N. Use NaiveDFT() for a reference implementation.
+	* The real-valued input only halves the FFT for an even N, an odd N runs a full N-point complex FFT (see RealDFT()).
+	* The twiddle factors come from the calling thread's cached Plan (see GetPlan()), repeated calls with the same N and K do no trigonometry.
 	*
 	* @param x Input real-valued signal. x.size() defines N.
-	* @param K Number of frequency bins that constitute the out signal. Any value K < N results in spectral loss so for lossless transfomation use K = x.size(). 
+	* @param K Number of frequency bins that constitute the out signal. Any value K < N results in spectral loss so for lossless transfomation use K = x.size().
 	* @param printProgress Whether to putput % progression of the operation to standard output. Just a piece of mind since simple DFT takes a long time to compute.
 	* @return Output of the function, the frequency bins resulting from the DFT. ComplexSignal of size K.
 	*/
@@ -26,7 +34,8 @@ namespace MyDFT
 
 	/**
 	* Inverse Discrete Fourier Transform. Computes the time-domain representation of a frequency-domain signal. In-place version.
-	* 
+	* Dispatches to the FFT engine (see IFFT()) through the calling thread's cached Plan. Use NaiveIDFT() for a reference implementation. To reconstruct only a range of samples for less than a full FFT, see PrunedIDFT().
+	*
 	* @param out Output of the function, the real-valued time-domain signal. Ensure out.size() is N before calling this function.
 	* @param y Input frequency bins, the frequency-domain representation of a signal. y.size() defines K.
 	* @param N Number of samples in the output real-valued signal out. Compute this as samplingFrequency * durationOfRealValuedSignal (as floats!). Setting this incorrectly results in a change in pitch.
@@ -35,6 +44,7 @@ namespace MyDFT
 
 	/**
 	* Inverse Discrete Fourier Transform. Computes the time-domain representation of a frequency-domain signal.  Out-of-place version.
+	* Dispatches to the FFT engine (see IFFT()) through the calling thread's cached Plan. Use NaiveIDFT() for a reference implementation.
 	*
 	* @param y Input frequency bins, the frequency-domain representation of a signal. y.size() defines K.
 	* @param N Number of samples in the output real-valued signal out. Compute this as samplingFrequency * durationOfRealValuedSignal (as floats!). Setting this incorrectly results in a change in pitch.
@@ -42,4 +52,234 @@ namespace MyDFT
 	* @return Output of the function, the real-valued time-domain signal. RealSignal of size N.
 	*/
 	std::vector<float> IDFT(const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress = true);
-}
\ No newline at end of file
+
+	// Non-zero frequency bin of a sparse spectrum.
+	struct SparseBin
+	{
+		unsigned int k = 0; // Bin index. Taken modulo N by the transforms.
+		std::complex<float> value; // Value of the bin.
+	};
+
+	// Spectrum storing only its non-zero bins, in any order. The bins left out are 0.
+	using SparseSpectrum = std::vector<SparseBin>;
+
+	/**
+	* Extracts the non-zero bins of a spectrum.
+	*
+	* @param y Input frequency bins.
+	* @param threshold Bins of magnitude threshold or less are dropped. 0 keeps every non-zero bin, a small positive value also drops the leakage around the peaks of a computed spectrum.
+	* @return The bins of y above threshold, in increasing order of k.
+	*/
+	SparseSpectrum MakeSparseSpectrum(const std::vector<std::complex<float>>& y, const float threshold = 0.0f);
+
+	/**
+	* Inverse Discrete Fourier Transform of a sparse spectrum. In-place version. Same result as IDFT() on the dense spectrum, but synthesizes the signal with an OscillatorBank (see MyOscillatorBank.h), one rotating phasor per bin.
+	* Costs O(y.size() * N) with no trigonometry per sample, so a spectrum of a few bins is rebuilt much faster than through an FFT, and N isn't limited by the memory of a dense spectrum.
+	*
+	* @param out Output of the function, the real-valued time-domain signal, clamped to [-1, 1] like IDFT(). Ensure out.size() is N before calling this function.
+	* @param y Input non-zero frequency bins.
+	* @param N Number of samples in the output real-valued signal out.
+	* @param printProgress Whether to output a message when the IDFT is done.
+	*/
+	void IDFT(std::vector<float>& out, const SparseSpectrum& y, const unsigned int N, const bool printProgress = true);
+
+	/**
+	* Inverse Discrete Fourier Transform of a sparse spectrum. Out-of-place version. See the in-place version.
+	*
+	* @param y Input non-zero frequency bins.
+	* @param N Number of samples in the output real-valued signal.
+	* @param printProgress Whether to output a message when the IDFT is done.
+	* @return The real-valued time-domain signal. RealSignal of size N.
+	*/
+	std::vector<float> IDFT(const SparseSpectrum& y, const unsigned int N, const bool printProgress = true);
+
+	/**
+	* Multithreaded Discrete Fourier Transform. In-place version. Same as DFT() but splits the work across the workers of a thread pool: the output bins when only a few are requested, the stages of the FFT otherwise (for N of at least FFTEngine::PARALLEL_MIN_LENGTH).
+	* Build the pool once and reuse it, e.g. MyUtils::ThreadPool pool(64); then call DFT(out, x, K, pool) for every signal.
+	*
+	* @param out Output of the function, the frequency bins resulting from the DFT. Ensure out.size() is K before calling this function.
+	* @param x Input real-valued signal. x.size() defines N.
+	* @param K Number of frequency bins that constitute the out signal.
+	* @param pool Thread pool to run on. Its thread count sets the parallelism.
+	* @param printProgress Whether to output a message when the DFT is done.
+	*/
+	void DFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int K, MyUtils::ThreadPool& pool, const bool printProgress = true);
+
+	/**
+	* Multithreaded Discrete Fourier Transform. Out-of-place version. See the in-place version.
+	*
+	* @param x Input real-valued signal. x.size() defines N.
+	* @param K Number of frequency bins that constitute the out signal.
+	* @param pool Thread pool to run on.
+	* @param printProgress Whether to output a message when the DFT is done.
+	* @return The frequency bins resulting from the DFT. ComplexSignal of size K.
+	*/
+	std::vector<std::complex<float>> DFT(const std::vector<float>& x, const unsigned int K, MyUtils::ThreadPool& pool, const bool printProgress = true);
+
+	/**
+	* Multithreaded Inverse Discrete Fourier Transform. In-place version. Same as IDFT() but splits the work across the workers of a thread pool: the output samples when only a few bins are given, the stages of the FFT otherwise.
+	*
+	* @param out Output of the function, the real-valued time-domain signal. Ensure out.size() is N before calling this function.
+	* @param y Input frequency bins. y.size() defines K.
+	* @param N Number of samples in the output real-valued signal out.
+	* @param pool Thread pool to run on. Its thread count sets the parallelism.
+	* @param printProgress Whether to output a message when the IDFT is done.
+	*/
+	void IDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, MyUtils::ThreadPool& pool, const bool printProgress = true);
+
+	/**
+	* Multithreaded Inverse Discrete Fourier Transform. Out-of-place version. See the in-place version.
+	*
+	* @param y Input frequency bins. y.size() defines K.
+	* @param N Number of samples in the output real-valued signal.
+	* @param pool Thread pool to run on.
+	* @param printProgress Whether to output a message when the IDFT is done.
+	* @return The real-valued time-domain signal. RealSignal of size N.
+	*/
+	std::vector<float> IDFT(const std::vector<std::complex<float>>& y, const unsigned int N, MyUtils::ThreadPool& pool, const bool printProgress = true);
+
+	/**
+	* Batched Discrete Fourier Transform of many signals of the same length, e.g. the frames of a spectrogram. Same result as calling DFT() on every frame, but all frames share one Plan and are transformed several at a time across the SIMD lanes (see Plan::ExecuteBatch()).
+	* Meant to be called in a loop: nothing is printed, and nothing is allocated once out has the right size.
+	*
+	* @param out Output of the function, frame f's bin k at out[f * K + k]. Resized to batch * K by the function.
+	* @param x Input real-valued signals stored back to back, frame f's sample n at x[f * N + n]. x.size() must be a multiple of N.
+	* @param N Number of samples per frame.
+	* @param K Number of frequency bins per frame.
+	*/
+	void BatchedDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int N, const unsigned int K);
+
+	/**
+	* Multithreaded batched Discrete Fourier Transform. Same as BatchedDFT() but the frames are split across the workers of a thread pool.
+	*
+	* @param out Output of the function, frame f's bin k at out[f * K + k]. Resized to batch * K by the function.
+	* @param x Input real-valued signals stored back to back. x.size() must be a multiple of N.
+	* @param N Number of samples per frame.
+	* @param K Number of frequency bins per frame.
+	* @param pool Thread pool to run on.
+	*/
+	void BatchedDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int N, const unsigned int K, MyUtils::ThreadPool& pool);
+
+	/**
+	* Batched Inverse Discrete Fourier Transform of many spectra with the same number of bins. Same result as calling IDFT() on every frame, without the clamping to [-1, 1], see BatchedDFT().
+	*
+	* @param out Output of the function, frame f's sample n at out[f * N + n]. Resized to batch * N by the function.
+	* @param y Input frequency bins stored back to back, frame f's bin k at y[f * K + k]. y.size() must be a multiple of K.
+	* @param N Number of samples per output frame.
+	* @param K Number of frequency bins per input frame.
+	*/
+	void BatchedIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const unsigned int K);
+
+	/**
+	* Multithreaded batched Inverse Discrete Fourier Transform. Same as BatchedIDFT() but the frames are split across the workers of a thread pool.
+	*
+	* @param out Output of the function, frame f's sample n at out[f * N + n]. Resized to batch * N by the function.
+	* @param y Input frequency bins stored back to back. y.size() must be a multiple of K.
+	* @param N Number of samples per output frame.
+	* @param K Number of frequency bins per input frame.
+	* @param pool Thread pool to run on.
+	*/
+	void BatchedIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const unsigned int K, MyUtils::ThreadPool& pool);
+
+	/**
+	* Real-to-complex Discrete Fourier Transform. Only computes the N/2+1 non-redundant bins of a real-valued signal, the others being X[N-k] = conj(X[k]). For an even N, the signal is packed into an N/2-point complex FFT: roughly half the work and half the memory of a complex transform of N points. An odd N runs a full N-point complex FFT, so only the output is halved.
+	*
+	* @param out Output of the function, bins 0 to N/2 included. Resized to N/2+1 by the function.
+	* @param x Input real-valued signal. x.size() defines N.
+	*/
+	void RealDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x);
+
+	/**
+	* Complex-to-real Inverse Discrete Fourier Transform. Inverse of RealDFT(): rebuilds the N samples of a real-valued signal from bins 0 to N/2 of its spectrum, the others being taken as X[N-k] = conj(X[k]). Same even-N restriction on the savings as RealDFT().
+	*
+	* @param out Output of the function, the real-valued time-domain signal. Resized to N by the function.
+	* @param y Input frequency bins 0 to N/2 included. y.size() must be N/2+1.
+	* @param N Number of samples in the output signal. Needed since N = 2 * (y.size() - 1) and N = 2 * (y.size() - 1) + 1 share the same number of bins.
+	*/
+	void RealIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N);
+
+	/**
+	* Reference O(N*K) Discrete Fourier Transform evaluating every e^(-i*2*PI*k*n/N) term directly. Slow, kept around for correctness comparisons. In-place version.
+	* Accumulates in float with the angle computed in float, so the error grows with N * K. See DirectDFT() in MyPreciseDFT.h for double, long double and compensated accumulation.
+	*
+	* @param out Output of the function, the frequency bins resulting from the DFT. Ensure out.size() is K before calling this function.
+	* @param x Input real-valued signal. x.size() defines N.
+	* @param K Number of frequency bins that constitute the out signal.
+	* @param printProgress Whether to putput % progression of the operation to standard output.
+	*/
+	void NaiveDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int K, const bool printProgress = true);
+
+	/**
+	* Reference O(N*K) Discrete Fourier Transform. Out-of-place version.
+	*
+	* @param x Input real-valued signal. x.size() defines N.
+	* @param K Number of frequency bins that constitute the out signal.
+	* @param printProgress Whether to putput % progression of the operation to standard output.
+	* @return The frequency bins resulting from the DFT. ComplexSignal of size K.
+	*/
+	std::vector<std::complex<float>> NaiveDFT(const std::vector<float>& x, const unsigned int K, const bool printProgress = true);
+
+	/**
+	* Reference O(N*K) Inverse Discrete Fourier Transform evaluating every e^(i*2*PI*k*n/N) term directly. Slow, kept around for correctness comparisons. In-place version.
+	* Same precision as NaiveDFT(), see DirectIDFT() in MyPreciseDFT.h for better.
+	*
+	* @param out Output of the function, the real-valued time-domain signal. Ensure out.size() is N before calling this function.
+	* @param y Input frequency bins. y.size() defines K.
+	* @param N Number of samples in the output real-valued signal out.
+	* @param printProgress Whether to putput % progression of the operation to standard output.
+	*/
+	void NaiveIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress = true);
+
+	/**
+	* Reference O(N*K) Inverse Discrete Fourier Transform. Out-of-place version.
+	*
+	* @param y Input frequency bins. y.size() defines K.
+	* @param N Number of samples in the output real-valued signal.
+	* @param printProgress Whether to putput % progression of the operation to standard output.
+	* @return The real-valued time-domain signal. RealSignal of size N.
+	*/
+	std::vector<float> NaiveIDFT(const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress = true);
+
+	/**
+	* Fast Fourier Transform of a complex-valued signal. Self-sorting (Stockham) mixed-radix implementation: N is factorized into radix-4 stages first, then radix-2, 3, 5 and a generic radix for any remaining prime factor.
+	* Any N is supported. The stages cost O(N * sum of the prime factors of N), so N = 8000 = 4^3 * 5^3 is fast, and N with a large prime factor goes through a ChirpZ (see MyChirpZ.h) instead of degrading to O(N^2).
+	*
+	* @param out Output of the function, the N frequency bins. Resized by the function.
+	* @param x Input complex-valued signal. x.size() defines N.
+	*/
+	void FFT(std::vector<std::complex<float>>& out, const std::vector<std::complex<float>>& x);
+
+	/**
+	* Inverse Fast Fourier Transform of a complex-valued signal. Normalized by 1/N so that IFFT(FFT(x)) == x.
+	*
+	* @param out Output of the function, the N time-domain samples. Resized by the function.
+	* @param y Input frequency bins. y.size() defines N.
+	*/
+	void IFFT(std::vector<std::complex<float>>& out, const std::vector<std::complex<float>>& y);
+
+	/**
+	* Multithreaded Fast Fourier Transform of a complex-valued signal. Same as FFT() but each stage is split across the workers of a thread pool, for N of at least FFTEngine::PARALLEL_MIN_LENGTH.
+	*
+	* @param out Output of the function, the N frequency bins. Resized by the function.
+	* @param x Input complex-valued signal. x.size() defines N.
+	* @param pool Thread pool to run on.
+	*/
+	void FFT(std::vector<std::complex<float>>& out, const std::vector<std::complex<float>>& x, MyUtils::ThreadPool& pool);
+
+	/**
+	* Multithreaded Inverse Fast Fourier Transform of a complex-valued signal. Normalized by 1/N.
+	*
+	* @param out Output of the function, the N time-domain samples. Resized by the function.
+	* @param y Input frequency bins. y.size() defines N.
+	* @param pool Thread pool to run on.
+	*/
+	void IFFT(std::vector<std::complex<float>>& out, const std::vector<std::complex<float>>& y, MyUtils::ThreadPool& pool);
+
+	/**
+	* Checks whether the FFT engine has a dedicated butterfly for every prime factor of N (that is N = 2^a * 3^b * 5^c). Other sizes still work but go through the slower generic radix or a ChirpZ.
+	*
+	* @param N Length of the transform.
+	* @return True if N only has 2, 3 and 5 as prime factors.
+	*/
+	bool IsFastSize(const unsigned int N);
+}
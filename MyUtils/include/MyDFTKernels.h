@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+
+namespace MyDFT
+{
+	namespace Kernels
+	{
+		// Instruction sets the kernels are compiled for, from slowest to fastest.
+		enum class InstructionSet : int
+		{
+			Scalar = 0,
+			SSE2, // 4 floats per instruction.
+			AVX2, // 8 floats per instruction, with FMA.
+			AVX512 // 16 floats per instruction.
+		};
+
+		/**
+		* Arguments of one self-sorting FFT stage of radix p on split complex data (real and imaginary parts in separate arrays), m = n / p butterflies of stride s:
+		* y[j, q, t] = w[j][t] * sum_r(a_r * w_p^(r*t)) with a_r = x[j, q, r]. Two memory layouts, picked per stage so that the kernels always have a long contiguous index to vectorize over:
+		*  - regular: a_r = x[q + s*(j + r*m)], y[q + s*(p*j + t)], contiguous in q. For the late stages, where s is large.
+		*  - transposed: a_r = x[j + m*(r + p*q)], y[j + m*(q + s*t)], contiguous in j. For the early stages, where m is large.
+		*/
+		struct StageArgs
+		{
+			const float* xr = nullptr; // Real parts of the stage's input.
+			const float* xi = nullptr; // Imaginary parts of the stage's input.
+			float* yr = nullptr; // Real parts of the stage's output.
+			float* yi = nullptr; // Imaginary parts of the stage's output.
+			const float* twr = nullptr; // Real parts of the twiddles, stored as [(t - 1) * m + j].
+			const float* twi = nullptr; // Imaginary parts of the twiddles.
+			size_t m = 0; // Number of butterflies per q, n / radix.
+			size_t s = 0; // Stride between the elements of a butterfly.
+			size_t jBegin = 0; // First j to compute. Ranges of j and q let several threads share a stage.
+			size_t jEnd = 0; // One past the last j to compute.
+			size_t qBegin = 0; // First q to compute.
+			size_t qEnd = 0; // One past the last q to compute.
+			bool transposed = false; // Whether the stage uses the transposed layout.
+			bool inverse = false; // Whether the stage belongs to an inverse transform, flips the sign of the roots of unity.
+		};
+
+		/**
+		* Arguments of a direct O(count * bins) DFT accumulation: out[o] = sum_i(in[i] * e^(sign*i*2*PI*o*i/N)) for o in [outBegin, outEnd).
+		* The exponentials are read from cos / sin tables of N entries, indexed by (o*i) % N, so the accumulation does no trigonometry. Vectorized over o.
+		*/
+		struct DirectArgs
+		{
+			const float* inRe = nullptr; // Real parts of the input.
+			const float* inIm = nullptr; // Imaginary parts of the input. nullptr for a real-valued input.
+			size_t count = 0; // Number of input values summed per output.
+			const float* cosTable = nullptr; // cos(2*PI*i/N) for i < N.
+			const float* sinTable = nullptr; // sin(2*PI*i/N) for i < N.
+			unsigned int N = 0; // Size of the tables, period of the exponentials.
+			size_t outBegin = 0; // First output to compute.
+			size_t outEnd = 0; // One past the last output to compute.
+			float* outRe = nullptr; // Real parts of the output, indexed from outBegin.
+			float* outIm = nullptr; // Imaginary parts of the output, indexed from outBegin. nullptr if only the real parts are needed.
+			float sign = -1.0f; // -1 for a forward transform, 1 for an inverse one.
+		};
+
+		constexpr size_t OSCILLATOR_VECTORS = 4; // Vectors of samples the oscillate kernel rotates side by side per partial, to hide the latency of the rotations.
+
+		// Set of kernels compiled for one instruction set.
+		struct KernelTable
+		{
+			InstructionSet instructionSet = InstructionSet::Scalar;
+			unsigned int width = 1; // Number of floats processed per instruction.
+			void (*radix2)(const StageArgs&) = nullptr;
+			void (*radix3)(const StageArgs&) = nullptr;
+			void (*radix4)(const StageArgs&) = nullptr;
+			void (*radix5)(const StageArgs&) = nullptr;
+			void (*direct)(const DirectArgs&) = nullptr;
+			void (*transpose)(const float* x, size_t xStride, float* y, size_t yStride, size_t rows, size_t cols) = nullptr; // y[c*yStride + r] = x[r*xStride + c] for r < rows, c < cols.
+			void (*multiplyAccumulate)(const float* aRe, const float* aIm, const float* bRe, const float* bIm, float* accRe, float* accIm, size_t count) = nullptr; // acc[i] += a[i] * b[i] for i < count, on split complex arrays.
+			void (*goertzel)(const float* x, size_t stride, size_t count, const float* coefficients, float* s1, float* s2, size_t lanes) = nullptr; // Runs the Goertzel recurrence s = x[n] + coefficients[l] * s1[l] - s2[l] of every lane l over count samples, updating the last two states s1, s2 in-place. Lane l reads x[n * stride + l], or x[n] if stride is 0. Vectorized over the lanes.
+			void (*slide)(const float* deltas, size_t count, const float* twiddlesRe, const float* twiddlesIm, float* binsRe, float* binsIm, size_t bins) = nullptr; // Runs the sliding DFT update bin[k] = twiddle[k] * (bin[k] + deltas[n]) of every bin k over count samples, in-place on split complex arrays. Vectorized over the bins.
+			void (*oscillate)(float* out, size_t count, const float* phasorsRe, const float* phasorsIm, const float* stepsRe, const float* stepsIm, size_t partials) = nullptr; // Adds the real part of partials rotating phasors to out[n] for n < count. Partial j starts with OSCILLATOR_VECTORS * width phasors phasors[j * OSCILLATOR_VECTORS * width + l], one per sample l, and rotates them by steps[j] every OSCILLATOR_VECTORS * width samples. Vectorized over the samples.
+		};
+
+		/**
+		* Queries the CPU (and OS support for the wider registers) for the best instruction set the kernels can use.
+		*
+		* @return Widest supported instruction set. Scalar on non-x86 CPUs.
+		*/
+		InstructionSet DetectInstructionSet();
+
+		/**
+		* Returns the kernels of the widest instruction set supported by the CPU. Detected once, on first call.
+		*
+		* @return Reference to the kernel table.
+		*/
+		const KernelTable& GetKernels();
+
+		/**
+		* Returns the kernels of a specific instruction set.
+		*
+		* @param instructionSet The desired instruction set.
+		* @return Pointer to the kernel table, nullptr if the CPU doesn't support the instruction set or if it wasn't compiled in.
+		*/
+		const KernelTable* GetKernels(const InstructionSet instructionSet);
+
+		/**
+		* Returns a printable name of an instruction set.
+		*/
+		const char* ToString(const InstructionSet instructionSet);
+
+		// Per instruction set tables, defined in their own translation units so that each can be compiled with its own code generation flags. nullptr if not compiled in.
+		const KernelTable* GetKernelsScalar_();
+		const KernelTable* GetKernelsSSE2_();
+		const KernelTable* GetKernelsAVX2_();
+		const KernelTable* GetKernelsAVX512_();
+	}
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <memory>
+
+#include "MyFFTEngine.h"
+
+namespace MyDFT
+{
+	constexpr size_t PLAN_CACHE_SIZE = 8; // Plans GetPlan() keeps per thread, the least recently used one gets evicted first.
+
+	/**
+	* Precomputed state for repeated transforms of the same size. Owns the FFTEngine twiddle tables and the scratch buffers, so that executing a Plan does no trigonometry and no heap allocation.
+	* Time-domain signals are real-valued, so the Plan only ever computes the N/2+1 non-redundant bins: an even N is packed into an N/2-point complex FFT, the other bins follow from Hermitian symmetry X[N-k] = conj(X[k]).
+	* When only a few bins are involved (2*K below FFTEngine::CostPerValue(N)) Execute() skips the FFT and accumulates the K bins directly with the SIMD kernels of MyDFTKernels.h, reading the exponentials from precomputed tables.
+	* A Plan is not thread-safe since its scratch buffers are shared between calls. Use one Plan per thread, GetPlan() does that for you.
+	*/
+	class Plan
+	{
+	public:
+		Plan() = delete;
+		/**
+		* Constructs a Plan. This is where the twiddle factors get computed.
+		*
+		* @param N Number of time-domain samples.
+		* @param K Number of frequency bins. Output bins of a Forward plan, input bins of an Inverse plan. Bins k >= N alias onto bin k % N.
+		* @param direction Whether the plan computes DFTs or IDFTs.
+		*/
+		Plan(const unsigned int N, const unsigned int K, const Direction direction);
+		/**
+		* Constructs a Plan for another number of bins, sharing the FFT engines and twiddle factors of a Plan of the same N and direction. The two Plans must then be used from the same thread.
+		*
+		* @param sameLength Plan whose engines get shared.
+		* @param K Number of frequency bins, see the other constructor.
+		*/
+		Plan(const Plan& sameLength, const unsigned int K);
+
+		/**
+		* Computes the K frequency bins of a real-valued signal. Only valid on Forward plans. Use K = N/2+1 to get only the non-redundant half of the spectrum.
+		*
+		* @param out Output frequency bins. Ensure out.size() is at least K before calling this method.
+		* @param x Input real-valued signal of size N.
+		* @param pool Optional thread pool to split the work across: the bins of a direct plan, the FFT stages otherwise.
+		*/
+		void Execute(std::vector<std::complex<float>>& out, const std::vector<float>& x, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Computes the N real-valued samples of a frequency-domain signal, normalized by 1/N. Only valid on Inverse plans. Like IDFT(), only the real part of the sum over the K bins is kept.
+		*
+		* @param out Output real-valued signal. Ensure out.size() is at least N before calling this method.
+		* @param y Input frequency bins of size K.
+		* @param pool Optional thread pool to split the work across: the samples of a direct plan, the FFT stages otherwise.
+		*/
+		void Execute(std::vector<float>& out, const std::vector<std::complex<float>>& y, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Computes the N real-valued samples of a Hermitian spectrum given by its N/2+1 first bins, normalized by 1/N. Only valid on Inverse plans, K is ignored. The missing bins are taken as X[N-k] = conj(X[k]).
+		*
+		* @param out Output real-valued signal. Ensure out.size() is at least N before calling this method.
+		* @param y Input frequency bins 0 to N/2 included.
+		* @param pool Optional thread pool to split the FFT stages across.
+		*/
+		void ExecuteHermitian(std::vector<float>& out, const std::vector<std::complex<float>>& y, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Computes the unnormalized N-point complex FFT in the Plan's direction. K is ignored. out and in may point to the same buffer.
+		* For even N the N-point engine is only built on the first call since real-valued transforms don't need it.
+		*
+		* @param out Output buffer of N complex values.
+		* @param in Input buffer of N complex values.
+		* @param pool Optional thread pool to split the FFT stages across.
+		*/
+		void ExecuteComplex(std::complex<float>* out, const std::complex<float>* in, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Computes the K frequency bins of count real-valued signals stored back to back. Only valid on Forward plans. Same result as calling Execute() on every frame, without any allocation once the first batch is done.
+		* Frames are transformed a vector width at a time, interleaved so that each SIMD lane holds one frame: short transforms vectorize fully instead of running their first stages on partial vectors.
+		*
+		* @param out Output bins, frame f's bin k at out[f * K + k]. Buffer of count * K values.
+		* @param x Input signals, frame f's sample n at x[f * N + n]. Buffer of count * N values.
+		* @param count Number of frames.
+		*/
+		void ExecuteBatch(std::complex<float>* out, const float* x, const size_t count);
+
+		/**
+		* Computes the N real-valued samples of count frequency-domain signals stored back to back, normalized by 1/N. Only valid on Inverse plans. Same result as calling Execute() on every frame, see the forward ExecuteBatch().
+		*
+		* @param out Output signals, frame f's sample n at out[f * N + n]. Buffer of count * N values.
+		* @param y Input bins, frame f's bin k at y[f * K + k]. Buffer of count * K values.
+		* @param count Number of frames.
+		*/
+		void ExecuteBatch(float* out, const std::complex<float>* y, const size_t count);
+
+		static constexpr size_t BATCH_MAX_FLOATS = 2048; // Largest interleaved batch, per real / imaginary array, ExecuteBatch() builds. Keeps the batch and the engine's scratch within a 32KB L1 cache.
+
+		const unsigned int N; // Number of time-domain samples.
+		const unsigned int K; // Number of frequency bins.
+		const Direction direction; // Direction of the transform.
+
+	private:
+		struct Shared_;
+
+		/**
+		* Constructs a Plan on the state shared by the Plans of length N.
+		*/
+		Plan(std::shared_ptr<Shared_> shared, const unsigned int N, const unsigned int K, const Direction direction);
+
+		/**
+		* Computes bins 0 to N/2 of x into half_.
+		*/
+		void ForwardHalf_(const float* x, MyUtils::ThreadPool* pool);
+
+		/**
+		* Computes the N real-valued samples of the Hermitian spectrum stored in half_, scaled by 1/N.
+		*/
+		void InverseHalf_(float* out, MyUtils::ThreadPool* pool);
+
+		/**
+		* Returns the number of frames ExecuteBatch() interleaves, and sizes the batch buffers for them.
+		*/
+		size_t BatchLanes_();
+
+		/**
+		* Writes the real engine input of x into re and im, every stride floats. An even N is packed as even samples in the real parts and odd samples in the imaginary parts, an odd N is copied as is with zero imaginary parts. A null x writes zeros.
+		*/
+		void PackReal_(float* re, float* im, const size_t stride, const float* x) const;
+
+		/**
+		* Turns the real engine output read from re and im every stride floats into bins 0 to N/2 in half_.
+		*/
+		void SplitHalf_(const float* re, const float* im, const size_t stride);
+
+		/**
+		* Inverse of SplitHalf_(): turns the Hermitian spectrum in half_ into the real engine input written every stride floats.
+		*/
+		void MergeHalf_(float* re, float* im, const size_t stride);
+
+		/**
+		* Inverse of PackReal_(): writes the N samples held in the real engine output into out, scaled by 1/N.
+		*/
+		void UnpackReal_(float* out, const float* re, const float* im, const size_t stride) const;
+
+		/**
+		* Writes the K output bins of a forward transform from half_.
+		*/
+		void SpreadBins_(std::complex<float>* out) const;
+
+		/**
+		* Folds the K input bins of an inverse transform into the Hermitian spectrum half_.
+		*/
+		void FoldBins_(const std::complex<float>* y);
+
+		/**
+		* Computes outputs values, each the sum of count inputs times the table exponentials. See Kernels::DirectArgs.
+		*/
+		void ExecuteDirect_(float* outRe, float* outIm, const float* inRe, const float* inIm, const size_t count, const size_t outputs, MyUtils::ThreadPool* pool);
+
+		std::shared_ptr<Shared_> shared_; // Engines and tables that only depend on N and the direction, shared with the Plans built from this one.
+		std::vector<float> workRe_; // Split buffer transformed by the real engine.
+		std::vector<float> workIm_;
+		std::vector<float> batchRe_; // Frames interleaved by ExecuteBatch(), one per SIMD lane. Sized on the first batch.
+		std::vector<float> batchIm_;
+		std::vector<std::complex<float>> half_; // Bins 0 to N/2 of the spectrum.
+		bool direct_ = false; // Whether Execute() uses direct accumulation rather than the FFT.
+		std::vector<float> directRe_; // Split copies of the direct accumulation's complex inputs or outputs.
+		std::vector<float> directIm_;
+	};
+
+	/**
+	* Returns a Plan from a cache of the calling thread, constructing it on first use. Plans are cached per (N, K, direction), up to PLAN_CACHE_SIZE of them: the least recently used one gets evicted to make room.
+	* A new Plan shares the engines of a cached Plan of the same N and direction, so that varying K costs a few buffers rather than another set of twiddle factors.
+	*
+	* @param N Number of time-domain samples.
+	* @param K Number of frequency bins.
+	* @param direction Whether the plan computes DFTs or IDFTs.
+	* @return The cached Plan, kept alive by the returned pointer even if it gets evicted meanwhile.
+	*/
+	std::shared_ptr<Plan> GetPlan(const unsigned int N, const unsigned int K, const Direction direction);
+
+	/**
+	* Frees the Plans cached by the calling thread, e.g. once done with a long signal. Plans still held elsewhere are freed when released. The caches of the other threads, those of a ThreadPool's workers included, are left alone.
+	*/
+	void ClearPlanCache();
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <memory>
+
+#include "MyDFTKernels.h"
+#include "MyThreadPool.h"
+
+namespace MyDFT
+{
+	// Which way a transform goes.
+	enum class Direction : int
+	{
+		Forward = 0, // Time-domain to frequency-domain, e^(-i*2*PI*k*n/N).
+		Inverse // Frequency-domain to time-domain, e^(i*2*PI*k*n/N).
+	};
+
+	class ChirpZ;
+	class FourStepFFT;
+
+	// How an FFTEngine decomposes its length. Picked by PlanEngine(), see MyPlanner.h.
+	struct EngineConfig
+	{
+		Kernels::InstructionSet instructionSet = Kernels::InstructionSet::Scalar; // Kernels the stages run with.
+		std::vector<unsigned int> radices; // Radix of every stage in execution order, their product being the length. Ignored by a ChirpZ and a FourStepFFT.
+		bool chirpZ = false; // Whether the whole length goes through a ChirpZ rather than stages.
+		bool fourStep = false; // Whether the whole length goes through a FourStepFFT rather than stages.
+	};
+
+	/**
+	* Unnormalized complex FFT of a fixed length, the building block of Plan. Prefer using a Plan, which handles real-valued signals and normalization on top of this.
+	* Self-sorting (Stockham) mixed-radix implementation: the length is factorized into radix-4 stages first, then radix-2, 3, 5 and a generic radix for any remaining prime factor. The output comes out in natural order, no bit-reversal pass needed.
+	* The generic radix costs O(p) per value, so lengths with a prime factor p of at least BLUESTEIN_MIN_FACTOR go through a ChirpZ instead, which stays O(length log length) for any length.
+	* Every stage streams the whole signal, so lengths of at least FOUR_STEP_MIN_LENGTH, too large for the cache, go through a FourStepFFT of cache-sized sub-transforms instead.
+	* Data is processed in split format (real and imaginary parts in separate arrays) by the SIMD kernels of MyDFTKernels.h, picked at runtime from the CPU's features.
+	* Those are the defaults, PlanEngine() can measure other radix orders, kernels and ChirpZ for the CPU at hand and hand them to the engine as an EngineConfig.
+	* Not thread-safe: the engine owns the scratch buffers its stages ping-pong with. A single transform can be shared by the workers of a ThreadPool though, each stage then gets split across them.
+	*/
+	class FFTEngine
+	{
+	public:
+		FFTEngine() = delete;
+		/**
+		* Constructs an FFTEngine. Computes the twiddle factors of every stage.
+		*
+		* @param length Number of complex values transformed.
+		* @param direction Sign of the exponent of the transform.
+		* @param kernels Kernels to run the stages with, in the default decomposition. nullptr leaves both to PlanEngine(): the best kernels the CPU supports unless the planner measured or loaded something faster.
+		*/
+		FFTEngine(const unsigned int length, const Direction direction, const Kernels::KernelTable* kernels = nullptr);
+
+		/**
+		* Constructs an FFTEngine with an explicit decomposition, see EngineConfig.
+		*
+		* @param length Number of complex values transformed.
+		* @param direction Sign of the exponent of the transform.
+		* @param config Decomposition of the length. Its instruction set must be supported by the CPU.
+		*/
+		FFTEngine(const unsigned int length, const Direction direction, const EngineConfig& config);
+
+		~FFTEngine();
+
+		/**
+		* Transforms length complex values in-place. Does not allocate.
+		* Converts to and from split format around TransformSplit(), prefer calling that one directly if the data can be kept split.
+		*
+		* @param data Buffer of length complex values.
+		* @param pool Optional thread pool to split the stages across. Only used for transforms of at least PARALLEL_MIN_LENGTH values, smaller ones don't amortize the synchronization.
+		*/
+		void Transform(std::complex<float>* data, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Transforms length complex values stored in split format in-place. Does not allocate.
+		*
+		* @param re Real parts, buffer of length floats.
+		* @param im Imaginary parts, buffer of length floats.
+		* @param pool Optional thread pool to split the stages across.
+		*/
+		void TransformSplit(float* re, float* im, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Transforms count signals of length complex values, stored in split format and interleaved value by value: value n of signal l is at index n * count + l. Does not allocate after the first call with a given count.
+		* Every stage then has count times more contiguous butterflies, so with count a multiple of the vector width all of them run vectorized, including the early stages of short transforms.
+		*
+		* @param re Real parts, buffer of length * count floats.
+		* @param im Imaginary parts, buffer of length * count floats.
+		* @param count Number of interleaved signals.
+		* @param pool Optional thread pool to split the stages across.
+		*/
+		void TransformInterleaved(float* re, float* im, const size_t count, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Estimates the cost of a transform of the given length, in operations per value. The sum of its prime factors for the stages, more for the convolution of a ChirpZ.
+		*
+		* @param length Number of complex values transformed.
+		* @return Rough number of operations per value.
+		*/
+		static unsigned int CostPerValue(const unsigned int length);
+
+		/**
+		* Default decomposition of a length into radices: radix-4 first since it needs fewer multiplications per value than two radix-2 stages, then the remaining primes in increasing order.
+		*
+		* @param length Length to factorize.
+		* @return Radices whose product is length. Empty for a length of 1.
+		*/
+		static std::vector<unsigned int> Factorize(unsigned int length);
+
+		/**
+		* Returns the decomposition the engine was built with.
+		*/
+		const EngineConfig& GetConfig() const;
+
+		static constexpr unsigned int PARALLEL_MIN_LENGTH = 1 << 14; // Transforms shorter than this ignore the thread pool.
+		static constexpr unsigned int BLUESTEIN_MIN_FACTOR = 11; // Smallest prime factor handled by a ChirpZ rather than a generic stage.
+		static constexpr unsigned int FOUR_STEP_MIN_LENGTH = 1 << 23; // Smallest length handled by a FourStepFFT: 64MB of data plus as much scratch, well past most last-level caches. Measuring finds the crossover of the CPU at hand.
+
+		const unsigned int length; // Number of complex values transformed.
+		const Direction direction; // Sign of the exponent of the transform.
+		const Kernels::KernelTable& kernels; // Kernels the stages run with.
+
+	private:
+		// Single pass of the engine: one radix-p butterfly per (j, q) pair.
+		struct Stage
+		{
+			unsigned int radix = 0;
+			size_t m = 0; // Length of the sub-transforms left to compute after this stage, n / radix.
+			size_t s = 0; // Stride between the elements of a sub-transform, product of the radices of the previous stages.
+			size_t twiddleOffset = 0; // Start of this stage's w_n^(j*t) in twiddlesRe_ and twiddlesIm_, stored as [(t - 1) * m + j].
+			size_t rootOffset = 0; // Start of this stage's w_radix^t in roots_. Only used by the generic butterfly.
+			bool transposed = false; // Whether the stage uses the transposed layout (see Kernels::StageArgs). The early stages, while m >= s.
+		};
+
+		/**
+		* Runs a single stage, reading from (xr, xi) and writing to (yr, yi). With a pool, transposed stages are split along j and regular ones along q, the long index of each layout.
+		*/
+		void RunStage_(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi, MyUtils::ThreadPool* pool) const;
+
+		/**
+		* Runs the butterflies j in [jBegin, jEnd), q in [qBegin, qEnd) of a stage.
+		*/
+		void RunStageRange_(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi, const size_t jBegin, const size_t jEnd, const size_t qBegin, const size_t qEnd) const;
+
+		/**
+		* Switches from the transposed layout to the regular one before the first regular stage: y[q + s*j] = x[j + n*q], with n and s of that stage.
+		*/
+		void Transpose_(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi, MyUtils::ThreadPool* pool) const;
+
+		/**
+		* Generic O(p^2) butterfly for the prime factors without a dedicated kernel.
+		*/
+		void RunGenericStage_(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi, const size_t jBegin, const size_t jEnd, const size_t qBegin, const size_t qEnd) const;
+
+		EngineConfig config_; // Decomposition the engine was built with.
+		std::vector<Stage> stages_; // Stages of the transform, in execution order. Empty when chirpZ_ or fourStep_ is used.
+		std::unique_ptr<ChirpZ> chirpZ_; // Bluestein transform of the whole length, for lengths with a prime factor of at least BLUESTEIN_MIN_FACTOR.
+		std::unique_ptr<FourStepFFT> fourStep_; // Cache-blocked transform of the whole length, for lengths of at least FOUR_STEP_MIN_LENGTH.
+		std::vector<float> twiddlesRe_; // Real parts of the twiddle factors of all stages.
+		std::vector<float> twiddlesIm_; // Imaginary parts of the twiddle factors of all stages.
+		std::vector<std::complex<float>> roots_; // Roots of unity of all stages.
+		std::vector<float> scratchRe_; // Buffers the stages ping-pong with the data being transformed.
+		std::vector<float> scratchIm_;
+		std::vector<float> splitRe_; // Split copy of the data transformed by Transform().
+		std::vector<float> splitIm_;
+	};
+}
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <utility>
+
+#include "MyMath.h"
+#include "MyFFTEngine.h"
+
+// The codelets must be inlined into each other for the twiddles to fold into constants. Compilers give up on their own with this many instantiations.
+#ifndef MYDFT_FORCEINLINE
+#if defined(_MSC_VER)
+#define MYDFT_FORCEINLINE __forceinline
+#else
+#define MYDFT_FORCEINLINE inline __attribute__((always_inline))
+#endif
+#endif
+
+namespace MyDFT
+{
+	namespace Fixed
+	{
+		/**
+		* sin(2*PI*k/n) and cos(2*PI*k/n), evaluable at compile time since std::sin and std::cos aren't constexpr. The angle is reduced to [-PI/4, PI/4] on the integers, so the series stay accurate to the last bit of a double.
+		*/
+		constexpr std::pair<double, double> SinCos(const size_t k, const size_t n)
+		{
+			// q = round(4k/n) quarter turns, and the remaining angle 2*PI*(k/n - q/4) of at most an eighth of a turn.
+			const size_t turn = k % n;
+			const size_t quadrant = (8 * turn + n) / (2 * n);
+			const double x = 2.0 * MyMath::PI_D * ((double)(4 * turn) - (double)(quadrant * n)) / (4.0 * (double)n);
+
+			double sin = 0.0, cos = 0.0, term = x;
+			for (int i = 1; i < 30; i += 2)
+			{
+				sin += term;
+				term *= -x * x / (double)((i + 1) * (i + 2));
+			}
+			term = 1.0;
+			for (int i = 0; i < 30; i += 2)
+			{
+				cos += term;
+				term *= -x * x / (double)((i + 1) * (i + 2));
+			}
+			switch (quadrant % 4)
+			{
+			case 0: return { sin, cos };
+			case 1: return { cos, -sin };
+			case 2: return { -sin, -cos };
+			default: return { -cos, sin };
+			}
+		}
+
+		/**
+		* Radix of the first stage of an n-point codelet: 4 first, then 2, 3 and 5, like FFTEngine. 0 if n has another prime factor.
+		*/
+		constexpr size_t Radix(const size_t n)
+		{
+			if (n % 4 == 0) return 4;
+			if (n % 2 == 0) return 2;
+			if (n % 3 == 0) return 3;
+			if (n % 5 == 0) return 5;
+			return 0;
+		}
+
+		/**
+		* Checks whether every prime factor of n is 2, 3 or 5.
+		*/
+		constexpr bool IsSupportedLength(size_t n)
+		{
+			if (n == 0) return false;
+			while (n > 1)
+			{
+				const size_t radix = Radix(n);
+				if (radix == 0) return false;
+				n /= radix;
+			}
+			return true;
+		}
+
+		/**
+		* Number of signals transformed side by side out of count of them: 8 if possible, so that the compiler can turn each operation into full SIMD vectors.
+		*/
+		constexpr size_t Batch(const size_t count)
+		{
+			size_t batch = 8;
+			while (count % batch != 0) batch /= 2;
+			return batch;
+		}
+
+		/**
+		* Length L of the sub-sequences a transform longer than a straight-line codelet is split into, N = P*L: the largest divisor of n with L*L <= n, at most maxLength, among those that batch best.
+		*/
+		constexpr size_t SubsequenceLength(const size_t n, const size_t maxLength)
+		{
+			size_t best = 1;
+			for (size_t l = 2; l <= maxLength && l * l <= n; ++l)
+			{
+				if (n % l == 0 && std::min(Batch(l), Batch(n / l)) >= std::min(Batch(best), Batch(n / best))) best = l;
+			}
+			return best;
+		}
+
+		// w_N^(r*k) = e^(-+i*2*PI*r*k/N) for r < ROWS and k < N/ROWS at [r * N/ROWS + k], built at compile time, contiguous in k like they are read: the last stage of an N-point codelet for ROWS = RADIX, the twiddle pass of a split transform for ROWS = L.
+		template<size_t N, size_t ROWS, class T, Direction D>
+		struct Twiddles
+		{
+			static constexpr std::array<T, N> MakeTable(const bool imaginary)
+			{
+				std::array<T, N> table{};
+				for (size_t r = 0; r < ROWS; ++r)
+				{
+					for (size_t k = 0; k < N / ROWS; ++k)
+					{
+						const std::pair<double, double> sinCos = SinCos(r * k, N);
+						const double sin = (D == Direction::Inverse) ? sinCos.first : -sinCos.first;
+						table[r * (N / ROWS) + k] = (T)(imaginary ? sin : sinCos.second);
+					}
+				}
+				return table;
+			}
+
+			static constexpr std::array<T, N> re = MakeTable(false);
+			static constexpr std::array<T, N> im = MakeTable(true);
+		};
+
+		// w_R^e = e^(-+i*2*PI*e/R) of a radix-R butterfly, for e < R.
+		template<size_t R, class T, Direction D>
+		struct Roots
+		{
+			static constexpr std::array<T, R> MakeTable(const bool imaginary)
+			{
+				std::array<T, R> table{};
+				for (size_t e = 0; e < R; ++e)
+				{
+					const std::pair<double, double> sinCos = SinCos(e, R);
+					const double sin = (D == Direction::Inverse) ? sinCos.first : -sinCos.first;
+					table[e] = (T)(imaginary ? sin : sinCos.second);
+				}
+				return table;
+			}
+
+			static constexpr std::array<T, R> re = MakeTable(false);
+			static constexpr std::array<T, R> im = MakeTable(true);
+		};
+
+		// Calls f.template operator()<I>() for I < COUNT, as straight-line code.
+		template<size_t COUNT, class F>
+		MYDFT_FORCEINLINE void Unroll(F&& f)
+		{
+			[&]<size_t... I>(std::index_sequence<I...>)
+			{
+				(f.template operator()<I>(), ...);
+			}(std::make_index_sequence<COUNT>{});
+		}
+	}
+
+	/**
+	* Complex FFT of a length N known at compile time, for the hot real-time paths where the buffer size never changes (e.g. the AudioEngine's 1024 samples). Unnormalized in both directions, like FFTEngine.
+	* Built from codelets generated by recursion on the template: an N-point codelet runs RADIX codelets of N/RADIX points on the interleaved sub-sequences of its input (decimation in time, radix 4 first then 2, 3 and 5), then N/RADIX radix-RADIX butterflies on constexpr twiddles.
+	* Codelets of up to UNROLL_MAX_LENGTH points are inlined into each other as straight-line code: no loops, no branches, and every twiddle folds into an immediate constant.
+	* A longer transform is split into N = P*L like in a PrunedPlan, L and P being as close to sqrt(N) as possible: P codelets of L points on the sub-sequences x[P*m + j], a twiddle pass, then L codelets of P points across them, X[k + L*q] = sum_j(w_P^(j*q) * w_N^(j*k) * Y_j[k]).
+	* Both steps run their codelets on 8 adjacent signals at once, so that the compiler turns each operation into SIMD vectors for the target it builds with. Up to 4096 points that's no more than two codelets deep, fully unrolling it instead would be hundreds of kilobytes of code that can't stay in the instruction cache.
+	* No plan, no allocation, no dispatch: it can be called from the audio thread. Scratch buffers are on the stack, 4*N values at most. For lengths only known at runtime, or long transforms, use a Plan.
+	*
+	* @tparam N Length of the transform, any product of 2, 3 and 5.
+	* @tparam T float or double.
+	*/
+	template<size_t N, class T = float>
+	class FixedFFT
+	{
+		static_assert(Fixed::IsSupportedLength(N), "FixedFFT only supports lengths whose prime factors are 2, 3 and 5.");
+
+	public:
+		static constexpr size_t UNROLL_MAX_LENGTH = 64; // Longest codelet generated as straight-line code.
+
+		/**
+		* Transforms N complex values.
+		*
+		* @param in Input buffer of N complex values.
+		* @param out Output buffer of N complex values, in natural order. Can be in itself.
+		*/
+		static void Forward(const std::complex<T>* in, std::complex<T>* out)
+		{
+			Transform_<Direction::Forward>(in, out);
+		}
+
+		/**
+		* Inverse transform of N complex values. Not normalized: divide by N to get back the input of Forward().
+		*
+		* @param in Input buffer of N complex values.
+		* @param out Output buffer of N complex values. Can be in itself.
+		*/
+		static void Inverse(const std::complex<T>* in, std::complex<T>* out)
+		{
+			Transform_<Direction::Inverse>(in, out);
+		}
+
+		/**
+		* Transforms N complex values stored in split format. Faster than the std::complex overload, which converts to and from split format around it.
+		*
+		* @param inRe Real parts of the input.
+		* @param inIm Imaginary parts of the input.
+		* @param outRe Real parts of the output. Must not overlap the input.
+		* @param outIm Imaginary parts of the output. Must not overlap the input.
+		*/
+		static void Forward(const T* inRe, const T* inIm, T* outRe, T* outIm)
+		{
+			TransformSplit_<Direction::Forward>(inRe, inIm, outRe, outIm);
+		}
+
+		/**
+		* Inverse transform of N complex values stored in split format. Not normalized.
+		*
+		* @param inRe Real parts of the input.
+		* @param inIm Imaginary parts of the input.
+		* @param outRe Real parts of the output. Must not overlap the input.
+		* @param outIm Imaginary parts of the output. Must not overlap the input.
+		*/
+		static void Inverse(const T* inRe, const T* inIm, T* outRe, T* outIm)
+		{
+			TransformSplit_<Direction::Inverse>(inRe, inIm, outRe, outIm);
+		}
+
+		/**
+		* Codelet, the building block of larger transforms: transforms BATCH signals side by side, value n of signal l being at inRe[n * IN_STRIDE + l] + i*inIm[n * IN_STRIDE + l].
+		* Value k of the output of signal l is written at outRe[k * OUT_STRIDE + l] and outIm[k * OUT_STRIDE + l]. Straight-line up to UNROLL_MAX_LENGTH points.
+		*
+		* @tparam D Direction of the transform.
+		* @tparam IN_STRIDE Distance between two values of an input signal, at least BATCH.
+		* @tparam OUT_STRIDE Distance between two values of an output signal, at least BATCH.
+		* @tparam BATCH Number of signals, adjacent in memory.
+		* @param inRe Real parts of the input.
+		* @param inIm Imaginary parts of the input.
+		* @param outRe Real parts of the output. Must not overlap the input.
+		* @param outIm Imaginary parts of the output. Must not overlap the input.
+		*/
+		template<Direction D, size_t IN_STRIDE, size_t OUT_STRIDE, size_t BATCH>
+		static MYDFT_FORCEINLINE void Execute(const T* inRe, const T* inIm, T* outRe, T* outIm)
+		{
+			if constexpr (N == 1)
+			{
+				for (size_t l = 0; l < BATCH; ++l)
+				{
+					outRe[l] = inRe[l];
+					outIm[l] = inIm[l];
+				}
+			}
+			else if constexpr (N <= UNROLL_MAX_LENGTH)
+			{
+				Fixed::Unroll<RADIX>([&]<size_t R>()
+					{
+						FixedFFT<M, T>::template Execute<D, IN_STRIDE * RADIX, OUT_STRIDE, BATCH>(inRe + R * IN_STRIDE, inIm + R * IN_STRIDE, outRe + R * M * OUT_STRIDE, outIm + R * M * OUT_STRIDE);
+					});
+				Fixed::Unroll<M>([&]<size_t K>()
+					{
+						Butterfly_<D, OUT_STRIDE, BATCH>(outRe, outIm, K);
+					});
+			}
+			else
+			{
+				ExecuteLooped_<D, IN_STRIDE, OUT_STRIDE, BATCH>(inRe, inIm, outRe, outIm);
+			}
+		}
+
+	private:
+		static constexpr size_t RADIX = Fixed::Radix(N); // Radix of the last stage of the codelet.
+		static constexpr size_t M = N / RADIX; // Length of its sub-codelets.
+		static constexpr size_t SUBSEQUENCE_LENGTH = Fixed::SubsequenceLength(N, UNROLL_MAX_LENGTH); // L, when N is longer than UNROLL_MAX_LENGTH.
+		static constexpr size_t SUBSEQUENCES = N / SUBSEQUENCE_LENGTH; // P.
+
+		/**
+		* Execute() of the codelets longer than UNROLL_MAX_LENGTH, only used by transforms longer than UNROLL_MAX_LENGTH^2. Not inlined, so that every sub-codelet is generated once.
+		*/
+		template<Direction D, size_t IN_STRIDE, size_t OUT_STRIDE, size_t BATCH>
+		static void ExecuteLooped_(const T* inRe, const T* inIm, T* outRe, T* outIm)
+		{
+			for (size_t r = 0; r < RADIX; ++r)
+			{
+				FixedFFT<M, T>::template Execute<D, IN_STRIDE * RADIX, OUT_STRIDE, BATCH>(inRe + r * IN_STRIDE, inIm + r * IN_STRIDE, outRe + r * M * OUT_STRIDE, outIm + r * M * OUT_STRIDE);
+			}
+			for (size_t k = 0; k < M; ++k)
+			{
+				Butterfly_<D, OUT_STRIDE, BATCH>(outRe, outIm, k);
+			}
+		}
+
+		/**
+		* Butterfly k of the last stage of a codelet, in-place on the outputs of its sub-codelets, sub-codelet r's at [r * M, (r + 1) * M): X[k + q*M] = sum_r(w_RADIX^(r*q) * w_N^(r*k) * Y_r[k]).
+		* re and im are restrict so that the compiler needn't check whether they alias to vectorize across the batch.
+		*/
+		template<Direction D, size_t OUT_STRIDE, size_t BATCH>
+		static MYDFT_FORCEINLINE void Butterfly_(T* __restrict re, T* __restrict im, const size_t k)
+		{
+			using Twiddles = Fixed::Twiddles<N, RADIX, T, D>;
+
+			for (size_t l = 0; l < BATCH; ++l)
+			{
+				T aRe[RADIX], aIm[RADIX];
+				aRe[0] = re[k * OUT_STRIDE + l];
+				aIm[0] = im[k * OUT_STRIDE + l];
+				for (size_t r = 1; r < RADIX; ++r)
+				{
+					const T wRe = Twiddles::re[r * M + k], wIm = Twiddles::im[r * M + k];
+					const T xRe = re[(r * M + k) * OUT_STRIDE + l], xIm = im[(r * M + k) * OUT_STRIDE + l];
+					aRe[r] = xRe * wRe - xIm * wIm;
+					aIm[r] = xRe * wIm + xIm * wRe;
+				}
+
+				if constexpr (RADIX == 2)
+				{
+					re[k * OUT_STRIDE + l] = aRe[0] + aRe[1];
+					im[k * OUT_STRIDE + l] = aIm[0] + aIm[1];
+					re[(k + M) * OUT_STRIDE + l] = aRe[0] - aRe[1];
+					im[(k + M) * OUT_STRIDE + l] = aIm[0] - aIm[1];
+				}
+				else if constexpr (RADIX == 4)
+				{
+					// (a1 - a3) * w_4, w_4 being -i forward and i inverse.
+					constexpr T sign = (D == Direction::Inverse) ? (T)1 : (T)-1;
+					const T evenRe = aRe[0] + aRe[2], evenIm = aIm[0] + aIm[2];
+					const T diffRe = aRe[0] - aRe[2], diffIm = aIm[0] - aIm[2];
+					const T oddRe = aRe[1] + aRe[3], oddIm = aIm[1] + aIm[3];
+					const T rotRe = -sign * (aIm[1] - aIm[3]), rotIm = sign * (aRe[1] - aRe[3]);
+					re[k * OUT_STRIDE + l] = evenRe + oddRe;
+					im[k * OUT_STRIDE + l] = evenIm + oddIm;
+					re[(k + M) * OUT_STRIDE + l] = diffRe + rotRe;
+					im[(k + M) * OUT_STRIDE + l] = diffIm + rotIm;
+					re[(k + 2 * M) * OUT_STRIDE + l] = evenRe - oddRe;
+					im[(k + 2 * M) * OUT_STRIDE + l] = evenIm - oddIm;
+					re[(k + 3 * M) * OUT_STRIDE + l] = diffRe - rotRe;
+					im[(k + 3 * M) * OUT_STRIDE + l] = diffIm - rotIm;
+				}
+				else
+				{
+					// Radix 3 and 5 are prime: a direct DFT on the roots w_RADIX^e, e = r*q % RADIX being 0 only on the first row and column.
+					using Roots = Fixed::Roots<RADIX, T, D>;
+					T sumRe = aRe[0], sumIm = aIm[0];
+					for (size_t r = 1; r < RADIX; ++r)
+					{
+						sumRe += aRe[r];
+						sumIm += aIm[r];
+					}
+					re[k * OUT_STRIDE + l] = sumRe;
+					im[k * OUT_STRIDE + l] = sumIm;
+					for (size_t q = 1; q < RADIX; ++q)
+					{
+						T yRe = aRe[0], yIm = aIm[0];
+						for (size_t r = 1; r < RADIX; ++r)
+						{
+							const size_t e = (r * q) % RADIX;
+							yRe += aRe[r] * Roots::re[e] - aIm[r] * Roots::im[e];
+							yIm += aRe[r] * Roots::im[e] + aIm[r] * Roots::re[e];
+						}
+						re[(k + q * M) * OUT_STRIDE + l] = yRe;
+						im[(k + q * M) * OUT_STRIDE + l] = yIm;
+					}
+				}
+			}
+		}
+
+		/**
+		* Transform of a length N longer than UNROLL_MAX_LENGTH, split into N = P*L.
+		*
+		* @param scratchRe Buffer of N values. Can be inRe, which is only read by the first step.
+		* @param scratchIm Buffer of N values. Can be inIm.
+		*/
+		template<Direction D>
+		static void Compose_(const T* inRe, const T* inIm, T* outRe, T* outIm, T* scratchRe, T* scratchIm)
+		{
+			constexpr size_t P = SUBSEQUENCES, L = SUBSEQUENCE_LENGTH;
+			using Twiddles = Fixed::Twiddles<N, L, T, D>;
+
+			// Y_j[k], output k of the L-point transform of x[P*m + j], at out[k * P + j].
+			constexpr size_t ROW_BATCH = Fixed::Batch(P);
+			for (size_t j = 0; j < P; j += ROW_BATCH)
+			{
+				FixedFFT<L, T>::template Execute<D, P, P, ROW_BATCH>(inRe + j, inIm + j, outRe + j, outIm + j);
+			}
+
+			// w_N^(j*k) * Y_j[k] at scratch[j * L + k]. Read in order with the twiddles, the transposed writes being the cheaper ones to scatter.
+			for (size_t k = 0; k < L; ++k)
+			{
+				for (size_t j = 0; j < P; ++j)
+				{
+					const T yRe = outRe[k * P + j], yIm = outIm[k * P + j];
+					const T wRe = Twiddles::re[k * P + j], wIm = Twiddles::im[k * P + j];
+					scratchRe[j * L + k] = yRe * wRe - yIm * wIm;
+					scratchIm[j * L + k] = yRe * wIm + yIm * wRe;
+				}
+			}
+
+			// X[k + L*q], output q of the P-point transform of the column k.
+			constexpr size_t COLUMN_BATCH = Fixed::Batch(L);
+			for (size_t k = 0; k < L; k += COLUMN_BATCH)
+			{
+				FixedFFT<P, T>::template Execute<D, L, L, COLUMN_BATCH>(scratchRe + k, scratchIm + k, outRe + k, outIm + k);
+			}
+		}
+
+		/**
+		* Transforms split values, with a single codelet or split into N = P*L.
+		*/
+		template<Direction D>
+		static void TransformSplit_(const T* inRe, const T* inIm, T* outRe, T* outIm)
+		{
+			if constexpr (N <= UNROLL_MAX_LENGTH)
+			{
+				Execute<D, 1, 1, 1>(inRe, inIm, outRe, outIm);
+			}
+			else
+			{
+				std::array<T, N> scratchRe, scratchIm;
+				Compose_<D>(inRe, inIm, outRe, outIm, scratchRe.data(), scratchIm.data());
+			}
+		}
+
+		/**
+		* Transforms interleaved complex values. A straight-line codelet reads them in place, as split format with a stride of 2, a longer transform splits them first.
+		*/
+		template<Direction D>
+		static void Transform_(const std::complex<T>* in, std::complex<T>* out)
+		{
+			std::array<T, N> re, im;
+			if constexpr (N <= UNROLL_MAX_LENGTH)
+			{
+				const T* values = reinterpret_cast<const T*>(in);
+				Execute<D, 2, 1, 1>(values, values + 1, re.data(), im.data());
+			}
+			else
+			{
+				std::array<T, N> splitRe, splitIm;
+				for (size_t n = 0; n < N; ++n)
+				{
+					splitRe[n] = in[n].real();
+					splitIm[n] = in[n].imag();
+				}
+				Compose_<D>(splitRe.data(), splitIm.data(), re.data(), im.data(), splitRe.data(), splitIm.data());
+			}
+			for (size_t n = 0; n < N; ++n)
+			{
+				out[n] = std::complex<T>(re[n], im[n]);
+			}
+		}
+	};
+}
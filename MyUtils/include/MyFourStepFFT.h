@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include "MyFFTEngine.h"
+
+namespace MyDFT
+{
+	/**
+	* Four-step (Bailey) FFT for lengths much larger than the last-level cache, where every stage of FFTEngine streams the whole signal from memory.
+	* The signal is viewed as a rows x columns matrix, x[n1 * columns + n2]. The transform then takes two passes over memory instead of one per stage:
+	* 1. The columns are transformed BLOCK at a time: gathered contiguously into a small buffer, rows-point FFTs, multiplied by the twiddles w_N^(k1*n2), and scattered back to a scratch buffer.
+	* 2. The rows, contiguous in the scratch buffer, get columns-point FFTs in place and are written back BLOCK at a time, transposed so that X[k1 + rows * k2] comes out in natural order.
+	* The sub-transforms are about sqrt(length) long and fit in the cache, their FFTEngines being planned like any other. Gathering, scattering and transposing BLOCK values at a time reads and writes whole cache lines, and the buffers are padded so that power-of-2 strides don't map to the same cache sets.
+	* With a thread pool the blocks of each pass are split across the workers, every one running its own sub-engines.
+	* Not thread-safe, the transform owns its scratch buffers.
+	*/
+	class FourStepFFT
+	{
+	public:
+		FourStepFFT() = delete;
+		/**
+		* Constructs a FourStepFFT. Computes the twiddle factors and plans the sub-transforms.
+		*
+		* @param length Number of complex values transformed. Must have a divisor other than 1 and itself, see SplitLength().
+		* @param direction Sign of the exponent of the transform.
+		*/
+		FourStepFFT(const unsigned int length, const Direction direction);
+
+		~FourStepFFT();
+
+		/**
+		* Transforms length complex values stored in split format in-place. Does not allocate, except for the sub-engines of the workers the first time a pool with more threads is used.
+		*
+		* @param re Real parts, buffer of length floats.
+		* @param im Imaginary parts, buffer of length floats.
+		* @param pool Optional thread pool to split the blocks of both passes across.
+		*/
+		void ExecuteSplit(float* re, float* im, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Returns the number of rows a length gets split into: its largest divisor no greater than its square root, so that both sub-transforms are as short as possible.
+		*
+		* @param length Length to split.
+		* @return Number of rows, 1 for lengths that can't be split.
+		*/
+		static unsigned int SplitLength(const unsigned int length);
+
+		static constexpr size_t BLOCK = 16; // Columns, then rows, moved together: a cache line of floats.
+
+		const unsigned int length; // Number of complex values transformed.
+		const Direction direction; // Sign of the exponent of the transform.
+		const unsigned int rows; // Length of the column transforms.
+		const unsigned int columns; // Length of the row transforms.
+
+	private:
+		// Sub-engines and buffers of one thread working on blocks.
+		struct Worker
+		{
+			Worker(const unsigned int rows, const unsigned int columns, const Direction direction);
+
+			FFTEngine columnEngine; // rows-point transforms.
+			FFTEngine rowEngine; // columns-point transforms.
+			std::vector<float> blockRe; // BLOCK columns gathered contiguously, each padded by BLOCK values.
+			std::vector<float> blockIm;
+			std::vector<float> baseRe; // w_N^(k1 * c) for the first column c of the block.
+			std::vector<float> baseIm;
+		};
+
+		/**
+		* Transforms the columns [begin, end), multiplies them by the twiddle factors and writes them to the scratch buffers.
+		*/
+		void ColumnPass_(Worker& worker, const float* re, const float* im, const size_t begin, const size_t end);
+
+		/**
+		* Transforms the rows [begin, end) of the scratch buffers in place and writes them transposed to (re, im).
+		*/
+		void RowPass_(Worker& worker, float* re, float* im, const size_t begin, const size_t end);
+
+		/**
+		* Runs pass(worker, begin, end) over [0, count) in blocks of BLOCK, split across the pool if there is one.
+		*/
+		template<class PASS>
+		void RunPass_(const size_t count, MyUtils::ThreadPool* pool, const PASS& pass);
+
+		std::vector<std::unique_ptr<Worker>> workers_; // One per thread that may work on blocks at the same time.
+		std::vector<Worker*> idleWorkers_; // Workers not currently used by a chunk of a pass. Guarded by workersMutex_.
+		std::mutex workersMutex_;
+		std::vector<float> coarseRe_; // w_N^(i * columns) for i < rows, split format. Twiddle w_N^q is coarse[q / columns] * fine[q % columns].
+		std::vector<float> coarseIm_;
+		std::vector<float> fineRe_; // w_N^j for j < columns.
+		std::vector<float> fineIm_;
+		std::vector<float> blockTwiddlesRe_; // w_N^(k1 * b) for b < BLOCK, stored as [b * rows + k1]: the twiddles of a block relative to its first column.
+		std::vector<float> blockTwiddlesIm_;
+		std::vector<float> scratchRe_; // Signal between the two passes, rows of columns values padded by BLOCK values.
+		std::vector<float> scratchIm_;
+	};
+}
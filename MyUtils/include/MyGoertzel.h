@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include "MyDFTKernels.h"
+
+namespace MyDFT
+{
+	/**
+	* Bank of Goertzel filters, each evaluating the spectrum of a stream at a single frequency. Samples are pushed block by block, and the bins of everything pushed since the last reset can be read at any time.
+	* A Goertzel filter costs one multiply-add per sample and per frequency, O(N) per bin rather than O(N log N) for the whole spectrum, so a handful of frequencies is much cheaper than an FFT. The frequencies don't have to fall on the bins of an FFT either.
+	* The recurrences of the different frequencies run side by side in the SIMD lanes of MyDFTKernels.h. With very few frequencies, the spare lanes run the same frequencies over later segments of the samples instead of idling.
+	* A single precision recurrence loses accuracy quadratically with its length near 0 and the Nyquist frequency, so it only runs over segments of SEGMENT_LENGTH samples, whose DFTs are summed in double precision.
+	*/
+	class GoertzelBank
+	{
+	public:
+		GoertzelBank() = delete;
+		/**
+		* Constructs a GoertzelBank.
+		*
+		* @param frequencies Frequencies to evaluate, any value in [0, sampleRate). Not limited to multiples of sampleRate / N.
+		* @param sampleRate Sampling rate of the stream, in the same unit as frequencies. Pass N to give frequencies as (possibly fractional) bin indices of an N-point DFT.
+		*/
+		GoertzelBank(const std::vector<float>& frequencies, const float sampleRate);
+
+		/**
+		* Runs the filters over the next samples of the stream. Does not allocate.
+		*
+		* @param samples Buffer of count samples.
+		* @param count Number of samples, any value.
+		*/
+		void Update(const float* samples, const size_t count);
+
+		/**
+		* Overload of Update() for a whole buffer.
+		*/
+		void Update(const std::vector<float>& samples);
+
+		/**
+		* Computes the DFT of the samples pushed since the last reset at every frequency: out[b] = sum_n(x[n] * e^(-i*2*PI*frequencies[b]*n/sampleRate)), n counted from the last reset.
+		*
+		* @param out Output bins, one per frequency. Resized by the function.
+		*/
+		void GetSpectrum(std::vector<std::complex<float>>& out) const;
+
+		/**
+		* Computes the squared magnitudes of the bins of GetSpectrum().
+		*
+		* @param out Output powers, one per frequency. Resized by the function.
+		*/
+		void GetPower(std::vector<float>& out) const;
+
+		/**
+		* Clears the filters, the next sample pushed is sample 0 again.
+		*/
+		void Reset();
+
+		/**
+		* Returns the number of samples pushed since the last reset.
+		*/
+		size_t GetSampleCount() const;
+
+	private:
+		static constexpr size_t SEGMENT_LENGTH = 64; // Samples per run of the recurrence.
+
+		// Double precision state of a filter across segments.
+		struct Filter
+		{
+			double omega = 0.0; // 2*PI*frequency/sampleRate.
+			std::complex<double> shift; // e^(-i*omega).
+			std::complex<double> step; // e^(-i*omega*SEGMENT_LENGTH).
+			std::complex<double> rotation; // e^(-i*omega*(start + SEGMENT_LENGTH - 1)), start being the first sample of the current segment.
+			std::complex<double> bin; // DFT of the completed segments.
+		};
+
+		/**
+		* Adds the current segment to the bins, from the final states of the recurrences over it, and moves on to the next segment.
+		*
+		* @param s1 Last state of the recurrence of every filter, at s1[b * stride].
+		* @param s2 State before last of every filter, at s2[b * stride].
+		* @param stride Distance between the states of two filters.
+		*/
+		void Fold_(const float* s1, const float* s2, const size_t stride);
+
+		/**
+		* Computes the DFT of the current segment of filter b while it's only partly pushed, relative to the start of the stream.
+		*/
+		std::complex<double> Partial_(const size_t b) const;
+
+		const Kernels::KernelTable& kernels_;
+		std::vector<Filter> filters_;
+		std::vector<float> coefficients_; // 2*cos(omega) of every filter, padded to a multiple of the kernel width.
+		std::vector<float> s1_; // Last state of every filter over the current segment.
+		std::vector<float> s2_; // State before last of every filter over the current segment.
+		size_t lanesPerBin_ = 1; // Most segments run side by side per filter when enough samples are pushed at once, to fill 4 vectors of the kernel.
+		std::vector<float> laneCoefficients_; // coefficients_ repeated once per segment run side by side.
+		std::vector<float> laneSamples_; // Segments transposed for the lanes, the samples of lane l at [n * lanes + l].
+		std::vector<float> laneS1_; // States of the lanes.
+		std::vector<float> laneS2_;
+		size_t segmentFill_ = 0; // Samples pushed into the current segment.
+		size_t count_ = 0; // Samples pushed since the last reset.
+	};
+
+	/**
+	* Evaluates the DFT of a real-valued signal at a list of bins with the Goertzel algorithm, see GoertzelBank. O(N) per bin, so much cheaper than DFT() when only a few bins matter, e.g. to detect a known tone.
+	*
+	* @param out Output of the function, out[b] = sum_n(x[n] * e^(-i*2*PI*bins[b]*n/N)). Resized to bins.size() by the function.
+	* @param x Input real-valued signal. x.size() defines N.
+	* @param bins Bins to evaluate. Can be fractional, a frequency f at sampling rate fs is bin f * N / fs.
+	*/
+	void Goertzel(std::vector<std::complex<float>>& out, const std::vector<float>& x, const std::vector<float>& bins);
+
+	/**
+	* Out-of-place version of Goertzel().
+	*
+	* @param x Input real-valued signal. x.size() defines N.
+	* @param bins Bins to evaluate, possibly fractional.
+	* @return One bin per entry of bins.
+	*/
+	std::vector<std::complex<float>> Goertzel(const std::vector<float>& x, const std::vector<float>& bins);
+}
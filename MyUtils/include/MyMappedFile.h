@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+
+namespace MyUtils
+{
+	/**
+	* File mapped in the address space of the process, for working on files larger than memory: the OS pages the parts being accessed in and out on its own.
+	* Prefetch() and Release() tell the OS which parts are needed next and which aren't anymore, so that the reads are issued ahead and the pages don't pile up.
+	* Uses mmap() and madvise() on POSIX systems, file mappings, PrefetchVirtualMemory() and VirtualUnlock() on Windows.
+	*/
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		* Unmaps the file if one is open.
+		*/
+		~MappedFile();
+
+		/**
+		* Maps an existing file read-only.
+		*
+		* @param path Path of the file.
+		* @return False if the file couldn't be opened or is empty.
+		*/
+		bool OpenRead(const char* path);
+
+		/**
+		* Creates a file of the given size, or truncates an existing one to it, and maps it read-write. Its content is zeros until written.
+		*
+		* @param path Path of the file.
+		* @param size Size of the file in bytes, at least 1.
+		* @return False if the file couldn't be created or mapped.
+		*/
+		bool Create(const char* path, const size_t size);
+
+		/**
+		* Unmaps the file. Written pages reach the disk in the background.
+		*/
+		void Close();
+
+		/**
+		* Asks the OS to start reading a range of the file in, without waiting for it. Extends the range to whole pages.
+		*
+		* @param offset Start of the range, in bytes.
+		* @param size Size of the range, in bytes.
+		*/
+		void Prefetch(const size_t offset, const size_t size) const;
+
+		/**
+		* Tells the OS that a range of the file won't be accessed for a while, so that its pages can leave the memory of the process. Written pages are kept and still reach the disk.
+		* Only the pages entirely within the range are released, those it shares with neighbouring data stay.
+		*
+		* @param offset Start of the range, in bytes.
+		* @param size Size of the range, in bytes.
+		*/
+		void Release(const size_t offset, const size_t size) const;
+
+		/**
+		* Returns whether a file is mapped.
+		*/
+		bool IsOpen() const;
+
+		/**
+		* Returns the start of the mapped file, nullptr if none is open.
+		*/
+		char* GetData() const;
+
+		/**
+		* Returns the size of the mapped file in bytes.
+		*/
+		size_t GetSize() const;
+
+	private:
+		/**
+		* Maps the whole file once it's been opened.
+		*/
+		bool Map_(const bool writable);
+
+		char* data_ = nullptr;
+		size_t size_ = 0;
+#if defined(_WIN32)
+		void* file_ = nullptr; // HANDLE of the file.
+		void* mapping_ = nullptr; // HANDLE of the file mapping.
+#else
+		int descriptor_ = -1;
+#endif
+	};
+}
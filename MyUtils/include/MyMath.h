@@ -6,6 +6,7 @@
 namespace MyMath
 {
 	constexpr const float PI = 3.14159265359f;
+	constexpr const double PI_D = 3.14159265358979323846; // Double precision PI, for precomputing tables that get rounded to float afterwards.
 
 	struct Vec2
 	{
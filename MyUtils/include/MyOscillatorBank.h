@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include "MyDFTKernels.h"
+
+namespace MyDFT
+{
+	/**
+	* Bank of sinusoidal oscillators, the synthesis counterpart of GoertzelBank: renders x[n] = sum_j(Re(amplitudes[j] * e^(i*2*PI*frequencies[j]*n/sampleRate))) as a stream, block by block.
+	* Every oscillator is a phasor rotated by a fixed step every sample, so rendering costs one complex multiply per sample and per partial and does no trigonometry.
+	* The samples are rendered side by side in the SIMD lanes of MyDFTKernels.h, each lane holding the phasor of its own sample and rotating by several vectors of samples at once.
+	* A single precision phasor slowly drifts away from the unit circle, so the phasors only run over blocks of BLOCK_VECTORS vectors of samples and are restarted from a double precision state at the start of every block.
+	*/
+	class OscillatorBank
+	{
+	public:
+		OscillatorBank() = delete;
+		/**
+		* Constructs an OscillatorBank. Every oscillator starts at phase 0, that is at its complex amplitude.
+		*
+		* @param frequencies Frequencies of the oscillators, any value. Not limited to multiples of sampleRate / N.
+		* @param amplitudes Complex amplitude of every oscillator: its magnitude and initial phase. Same size as frequencies.
+		* @param sampleRate Sampling rate of the stream, in the same unit as frequencies. Pass N to give frequencies as (possibly fractional) bin indices of an N-point DFT.
+		*/
+		OscillatorBank(const std::vector<float>& frequencies, const std::vector<std::complex<float>>& amplitudes, const float sampleRate);
+
+		/**
+		* Renders the next samples of the stream, overwriting out. O(partials * count). Does not allocate.
+		*
+		* @param out Buffer of count samples.
+		* @param count Number of samples, any value.
+		*/
+		void Render(float* out, const size_t count);
+
+		/**
+		* Overload of Render() for a whole buffer, out.size() samples.
+		*/
+		void Render(std::vector<float>& out);
+
+		/**
+		* Rewinds the oscillators, the next sample rendered is sample 0 again.
+		*/
+		void Reset();
+
+	private:
+		static constexpr size_t BLOCK_VECTORS = 256; // Vectors of samples per run of the single precision phasors, 64 rotations of each. Counted in vectors rather than samples so that the accuracy doesn't depend on the kernel width.
+
+		// Double precision state of an oscillator across blocks.
+		struct Oscillator
+		{
+			double omega = 0.0; // 2*PI*frequency/sampleRate.
+			std::complex<double> amplitude; // Value at sample 0.
+			std::complex<double> step; // e^(i*omega*blockLength_).
+			std::complex<double> phasor; // amplitude * e^(i*omega*start), start being the first sample of the current block.
+		};
+
+		const Kernels::KernelTable& kernels_;
+		size_t blockLength_ = 0; // Samples per block, BLOCK_VECTORS times the kernel width.
+		std::vector<Oscillator> oscillators_;
+		size_t lanes_ = 0; // Phasors per oscillator, Kernels::OSCILLATOR_VECTORS times the kernel width.
+		std::vector<std::complex<double>> laneRotations_; // e^(i*omega*l) of oscillator j for l < lanes_, at [j * lanes_ + l].
+		std::vector<float> phasorsRe_; // Phasors of the current block, oscillator j's sample l at [j * lanes_ + l], split format.
+		std::vector<float> phasorsIm_;
+		std::vector<float> stepsRe_; // e^(i*omega*lanes_) of every oscillator, the rotation of the phasors, split format.
+		std::vector<float> stepsIm_;
+	};
+}
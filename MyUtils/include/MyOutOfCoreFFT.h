@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+#include "MyFFTEngine.h"
+
+namespace MyDFT
+{
+	constexpr size_t OUT_OF_CORE_DEFAULT_BUDGET = (size_t)256 << 20; // Memory the blocks of an out-of-core FFT may use by default, in bytes.
+
+	/**
+	* Out-of-core FFT: transforms a signal stored in a file into a spectrum written to another file, for signals too large to be held in memory. Both files are memory-mapped, see MyUtils::MappedFile.
+	* Four-step algorithm (see FourStepFFT) with the length viewed as a rows x columns matrix, in two passes over the files:
+	* 1. Blocks of columns are read, each row contributing a segment of the block's width, transformed and multiplied by the twiddle factors. Every block is written transposed, which makes it one contiguous range of the output file.
+	* 2. Blocks of rows of the output file are read the same way, transformed and written back in place, in natural order.
+	* The blocks are as wide as the memory budget allows, so that the segments are long enough for the disk to stream them. The segments of the next block get prefetched while the current one is transformed, and the pages of the blocks done are released.
+	* The sub-transforms are about sqrt(length) long, the length should thus have a divisor close to its square root: smooth lengths, e.g. zero-padded to a power of 2, are best.
+	*
+	* @param outputPath File to write the spectrum to: length std::complex<float>, created or overwritten. Must not be the input file.
+	* @param inputPath File of the signal, raw 32-bit floats in the byte order of the CPU: the samples of a real-valued signal, or the interleaved real and imaginary parts of a complex-valued one. Its size gives the length.
+	* @param realInput Whether the input file holds a real-valued signal.
+	* @param direction Sign of the exponent of the transform. Unnormalized both ways, like FFTEngine.
+	* @param memoryBudget Memory the blocks may use, in bytes. The page cache holding the segments being prefetched comes on top of it.
+	* @param pool Optional thread pool to split the sub-transforms across.
+	* @return False if a file couldn't be opened or created, or the input is empty.
+	*/
+	bool OutOfCoreFFT(const char* outputPath, const char* inputPath, const bool realInput, const Direction direction, const size_t memoryBudget = OUT_OF_CORE_DEFAULT_BUDGET, MyUtils::ThreadPool* pool = nullptr);
+}
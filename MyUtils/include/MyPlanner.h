@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+
+#include "MyFFTEngine.h"
+
+// Where the wisdom is kept between runs by default. CMake points it at the build directory.
+#ifndef MYDFT_WISDOM_PATH
+#define MYDFT_WISDOM_PATH "MyDFTWisdom.txt"
+#endif
+
+namespace MyDFT
+{
+	// How PlanEngine() decides the decomposition of a length it has no wisdom about.
+	enum class PlannerMode : int
+	{
+		Estimate = 0, // Default. Heuristics only, see EstimateEngine(): planning costs nothing, for latency-sensitive startups.
+		Measure // Times the candidate decompositions of every new length and keeps the fastest as wisdom. Tens of milliseconds per length the first time.
+	};
+
+	/**
+	* Picks the decomposition of an FFTEngine of the given length, the one every engine built without explicit kernels goes through. Thread-safe.
+	* Returns the wisdom about the length if there is some, measured earlier in the process or loaded with LoadWisdom(). Otherwise estimates or measures it depending on the planner mode, measurements being added to the wisdom.
+	*
+	* @param length Number of complex values transformed.
+	* @param direction Sign of the exponent of the transform. Both directions share the same wisdom, their kernels cost the same.
+	* @return Decomposition to construct the engine with.
+	*/
+	EngineConfig PlanEngine(const unsigned int length, const Direction direction);
+
+	/**
+	* Default decomposition of a length, without measuring anything: FFTEngine::Factorize()'s radices, a ChirpZ for lengths with a prime factor of at least FFTEngine::BLUESTEIN_MIN_FACTOR, or a FourStepFFT for lengths of at least FFTEngine::FOUR_STEP_MIN_LENGTH.
+	*
+	* @param length Number of complex values transformed.
+	* @param instructionSet Kernels to run the stages with.
+	* @return Estimated decomposition.
+	*/
+	EngineConfig EstimateEngine(const unsigned int length, const Kernels::InstructionSet instructionSet);
+
+	/**
+	* Benchmarks the candidate decompositions of a length and returns the fastest. Does not touch the wisdom.
+	* The radix orders are timed with the widest kernels first, then the other instruction sets with the fastest order, a ChirpZ against the generic stages of lengths with a prime factor above 5, and a FourStepFFT for lengths close to the size of the cache.
+	*
+	* @param length Number of complex values transformed.
+	* @param direction Sign of the exponent of the transform.
+	* @return Fastest decomposition.
+	*/
+	EngineConfig MeasureEngine(const unsigned int length, const Direction direction);
+
+	/**
+	* Sets how PlanEngine() plans lengths it has no wisdom about. Engines already built keep their decomposition.
+	*/
+	void SetPlannerMode(const PlannerMode mode);
+
+	/**
+	* Returns how PlanEngine() plans lengths it has no wisdom about.
+	*/
+	PlannerMode GetPlannerMode();
+
+	/**
+	* Adds the wisdom saved by SaveWisdom() to the one of the process. Entries for instruction sets the CPU doesn't support are skipped, the file may come from another machine.
+	*
+	* @param path Text file to read.
+	* @return False if the file couldn't be opened, e.g. on the first run. Malformed lines are skipped.
+	*/
+	bool LoadWisdom(const std::string& path = MYDFT_WISDOM_PATH);
+
+	/**
+	* Writes the wisdom of the process to a text file, one length per line, so that later runs reuse the measurements with LoadWisdom().
+	*
+	* @param path Text file to write, overwritten.
+	* @return False if the file couldn't be written.
+	*/
+	bool SaveWisdom(const std::string& path = MYDFT_WISDOM_PATH);
+
+	/**
+	* Forgets the wisdom of the process. Engines already built keep their decomposition.
+	*/
+	void ForgetWisdom();
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <memory>
+
+#include "MyFFTEngine.h"
+
+namespace MyDFT
+{
+	/**
+	* Precomputed state for pruned transforms: a Forward plan computes only bins [begin, end) of a real-valued signal of N samples, an Inverse plan only samples [begin, end) of its IDFT. Much cheaper than a full transform when the range is narrow, e.g. the 0-4kHz band of a 48kHz signal.
+	* The transform is split by decimation in time, N' = P*M: the P interleaved sub-sequences x[P*m + r] go through M-point FFTs, side by side with FFTEngine::TransformInterleaved(), and only the requested outputs are combined from them: X[h] = sum_r(w_N'^(r*h) * Y_r[h % M]).
+	* That costs about N' * FFTEngine::CostPerValue(M) + B * P for B outputs: P is picked at construction to minimize it, from P = 1 (a full FFT) to a direct O(N * B) sum for the narrowest ranges.
+	* An even N is packed in an N/2-point complex transform like in Plan, which then needs the mirrored range as well to split the packed spectrum.
+	* Not thread-safe, the plan owns its scratch buffers.
+	*/
+	class PrunedPlan
+	{
+	public:
+		PrunedPlan() = delete;
+		/**
+		* Constructs a PrunedPlan. Picks the decimation and computes the twiddle factors of the requested range.
+		*
+		* @param N Number of time-domain samples, the size of the transform.
+		* @param begin First bin of a Forward plan, first sample of an Inverse plan.
+		* @param end One past the last bin or sample, at most N.
+		* @param direction Whether the plan computes bins of DFTs or samples of IDFTs.
+		*/
+		PrunedPlan(const unsigned int N, const unsigned int begin, const unsigned int end, const Direction direction);
+
+		/**
+		* Computes bins [begin, end) of a real-valued signal. Only valid on Forward plans.
+		*
+		* @param out Output bins, out[i] being bin begin + i. Ensure out.size() is at least end - begin before calling this method.
+		* @param x Input real-valued signal of size N.
+		* @param pool Optional thread pool to split the FFT stages across.
+		*/
+		void Execute(std::vector<std::complex<float>>& out, const std::vector<float>& x, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Computes samples [begin, end) of the IDFT of a frequency-domain signal, normalized by 1/N. Only valid on Inverse plans. Like IDFT(), only the real part of the sum is kept.
+		*
+		* @param out Output samples, out[i] being sample begin + i. Ensure out.size() is at least end - begin before calling this method.
+		* @param y Input frequency bins, any number of them. Bins k >= N alias onto bin k % N.
+		* @param pool Optional thread pool to split the FFT stages across.
+		*/
+		void Execute(std::vector<float>& out, const std::vector<std::complex<float>>& y, MyUtils::ThreadPool* pool = nullptr);
+
+		/**
+		* Returns the decimation P the transform was split with: 1 for a full FFT, 0 for a direct sum.
+		*/
+		unsigned int GetDecimation() const;
+
+		const unsigned int N; // Number of time-domain samples.
+		const unsigned int begin; // First bin or sample computed.
+		const unsigned int end; // One past the last bin or sample computed.
+		const Direction direction; // Direction of the transform.
+
+	private:
+		// Contiguous run of outputs h of the N'-point transform, wrapping around N'.
+		struct Range
+		{
+			size_t first = 0; // First output h.
+			size_t length = 0; // Number of outputs.
+			size_t offset = 0; // Where the range starts in the accumulators.
+		};
+
+		/**
+		* Picks the cheapest decimation for outputs_ outputs of a length_-point transform, 0 if a direct sum of the N samples or bins beats all of them.
+		*/
+		void ChooseDecimation_();
+
+		/**
+		* Computes the outputs of the ranges from the length_ values in workRe_ and workIm_ into accRe_ and accIm_. Overwrites the work buffers.
+		*/
+		void Prune_(MyUtils::ThreadPool* pool);
+
+		/**
+		* Runs the direct sum of count split inputs into outputs [begin, end), see Kernels::DirectArgs.
+		*/
+		void ExecuteDirect_(float* outRe, float* outIm, const float* inRe, const float* inIm, const size_t count) const;
+
+		static constexpr size_t COMBINE_OVERHEAD = 16; // Fixed cost of combining a sub-sequence, in outputs. Keeps short ranges from being split into many tiny sub-transforms.
+
+		const Kernels::KernelTable& kernels_;
+		size_t length_ = 0; // N', N/2 for an even N, N for an odd one.
+		size_t decimation_ = 0; // P, 0 for a direct sum.
+		std::unique_ptr<FFTEngine> engine_; // M-point engine of the sub-sequences. Not built for a direct sum.
+		std::vector<Range> ranges_; // Outputs of the N'-point transform to compute.
+		size_t outputs_ = 0; // Total length of the ranges.
+		std::vector<float> twiddlesRe_; // w_N'^(r*h) of output i of the ranges at [r * outputs_ + i], split format.
+		std::vector<float> twiddlesIm_;
+		std::vector<std::complex<float>> splitTwiddles_; // e^(-+i*2*PI*k/N) to split or merge the packed transform of an even N: for the bins of the range in a Forward plan, for k < N/2 in an Inverse one.
+		std::vector<float> workRe_; // Values transformed by engine_, N' of them. The N folded bins of an Inverse plan for a direct sum.
+		std::vector<float> workIm_;
+		std::vector<std::complex<float>> folded_; // Bins of an Inverse plan folded onto N bins, when there are more or less than N of them.
+		std::vector<float> gatherRe_; // Outputs of the sub-transforms needed by the ranges, sub-sequence r's at [r * outputs_ + i].
+		std::vector<float> gatherIm_;
+		std::vector<float> accRe_; // Outputs of the ranges.
+		std::vector<float> accIm_;
+		std::vector<float> cosTable_; // cos(2*PI*n/N) for n < N. Only for a direct sum.
+		std::vector<float> sinTable_; // sin(2*PI*n/N) for n < N. Only for a direct sum.
+	};
+
+	/**
+	* Computes bins [k0, k1) of the DFT of a real-valued signal, with a PrunedPlan. Same bins as DFT() for a fraction of the cost when the band is narrow.
+	* The plan is built on every call, keep a PrunedPlan to analyze the same band of many signals.
+	*
+	* @param out Output of the function, out[i] = sum_n(x[n] * e^(-i*2*PI*(k0+i)*n/N)). Resized to k1 - k0 by the function.
+	* @param x Input real-valued signal. x.size() defines N.
+	* @param k0 First bin.
+	* @param k1 One past the last bin, at most N.
+	*/
+	void PrunedDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int k0, const unsigned int k1);
+
+	/**
+	* Computes samples [n0, n1) of the IDFT of a frequency-domain signal, with a PrunedPlan. Same samples as IDFT(), without the clamping to [-1, 1], for a fraction of the cost when the range is short.
+	* The plan is built on every call, keep a PrunedPlan to reconstruct the same range of many spectra.
+	*
+	* @param out Output of the function, out[i] being sample n0 + i of the real-valued time-domain signal. Resized to n1 - n0 by the function.
+	* @param y Input frequency bins. y.size() defines K.
+	* @param N Number of samples of the whole time-domain signal.
+	* @param n0 First sample.
+	* @param n1 One past the last sample, at most N.
+	*/
+	void PrunedIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const unsigned int n0, const unsigned int n1);
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+#include <functional>
+
+#include "MyDFTPlan.h"
+
+namespace MyDFT
+{
+	// Tapering applied to every frame of a Short-Time Fourier Transform before its DFT.
+	enum class WindowType : int
+	{
+		Hann = 0, // 0.5 - 0.5*cos(2*PI*n/N). Sums to a constant at hops of N/2 and N/4.
+		Hamming, // 0.54 - 0.46*cos(2*PI*n/N). Same hops as Hann, lower first sidelobe but never reaches zero.
+		Blackman // 0.42 - 0.5*cos(2*PI*n/N) + 0.08*cos(4*PI*n/N). Lowest sidelobes, widest main lobe. Sums to a constant at hops of N/3.
+	};
+
+	/**
+	* Computes a periodic window, the variant that tiles without overlap gaps (DFT-even): its period is length samples rather than length - 1.
+	*
+	* @param type Shape of the window.
+	* @param length Number of samples.
+	* @return The window's samples.
+	*/
+	std::vector<float> MakeWindow(const WindowType type, const unsigned int length);
+
+	/**
+	* Streaming Short-Time Fourier Transform. Samples are pushed in chunks of any size, and every hop samples the last N of them get windowed and transformed into the N/2+1 non-redundant bins of a spectral frame.
+	* Memory stays constant however long the stream runs: the last N samples live in a ring buffer, the window, the frame and the spectrum are allocated once by the constructor, and the transform goes through a Plan owned by the STFT.
+	*/
+	class STFT
+	{
+	public:
+		/**
+		* Called with every spectral frame: its N/2+1 bins, and its index. Frame f covers the input samples [f*hop - padding, f*hop - padding + N), padding being N - hop if the STFT pads its start and 0 otherwise.
+		* The spectrum is only valid for the duration of the call.
+		*/
+		using FrameCallback = std::function<void(const std::vector<std::complex<float>>& spectrum, const size_t frameIndex)>;
+
+		STFT() = delete;
+		/**
+		* Constructs an STFT.
+		*
+		* @param N Frame length in samples, also the DFT size.
+		* @param hop Number of samples between the starts of two consecutive frames, in [1, N].
+		* @param window Window applied to every frame.
+		* @param padStart Whether the stream starts as if preceded by N - hop zeros. The first frame then comes after hop samples rather than N, and every sample is covered by the same number of frames, which the inverse STFT needs to rebuild the start of the signal.
+		*/
+		STFT(const unsigned int N, const unsigned int hop, const WindowType window = WindowType::Hann, const bool padStart = true);
+
+		/**
+		* Appends samples to the stream, calling onFrame for every frame they complete. Does not allocate.
+		*
+		* @param samples Buffer of count samples.
+		* @param count Number of samples, any value.
+		* @param onFrame Function receiving the completed frames, in order.
+		*/
+		void Push(const float* samples, const size_t count, const FrameCallback& onFrame);
+
+		/**
+		* Overload of Push() for a whole buffer.
+		*/
+		void Push(const std::vector<float>& samples, const FrameCallback& onFrame);
+
+		/**
+		* Ends the stream: pads it with zeros until a last frame covers the final sample pushed, then resets the STFT. With padStart the end is padded with up to N - hop zeros too, so the last samples are covered by as many frames as the others.
+		*
+		* @param onFrame Function receiving the completed frames.
+		*/
+		void Flush(const FrameCallback& onFrame);
+
+		/**
+		* Forgets every pushed sample, as if the STFT was just constructed.
+		*/
+		void Reset();
+
+		/**
+		* Returns the window applied to the frames.
+		*/
+		const std::vector<float>& GetWindow() const;
+
+		const unsigned int N; // Frame length.
+		const unsigned int hop; // Samples between consecutive frames.
+		const bool padStart; // Whether the stream is preceded by N - hop zeros.
+
+	private:
+		/**
+		* Windows the N samples of the ring buffer, oldest first, transforms them and hands the spectrum to onFrame.
+		*/
+		void EmitFrame_(const FrameCallback& onFrame);
+
+		Plan plan_; // Forward plan computing bins 0 to N/2.
+		std::vector<float> window_;
+		std::vector<float> ring_; // Last N samples of the stream. The oldest one is at writePos_.
+		std::vector<float> frame_; // Windowed frame handed to the plan.
+		std::vector<std::complex<float>> spectrum_; // Bins 0 to N/2 of the last frame.
+		size_t writePos_ = 0; // Where the next sample goes in ring_.
+		size_t untilFrame_ = 0; // Samples left to push before the next frame.
+		size_t frameIndex_ = 0; // Index of the next frame.
+		size_t pushed_ = 0; // Samples pushed since the last reset, padding excluded.
+	};
+
+	/**
+	* Streaming inverse Short-Time Fourier Transform by weighted overlap-add (WOLA). Every pushed frame is transformed back, multiplied by the synthesis window and added to the frames before it. Once a frame is in, its first hop samples can't change anymore and get handed out.
+	* Frames of an STFT with the same parameters come back out as the original signal: the overlap-added windows are divided out by their steady-state sum, sum over m of window[n + m*hop]^2, which is periodic in hop.
+	* The output lags the frames by N - hop samples and memory stays constant: the overlap-add accumulator is a ring of N samples.
+	*/
+	class ISTFT
+	{
+	public:
+		/**
+		* Called with the samples completed by a frame, hop of them or less for the first frames. The buffer is only valid for the duration of the call.
+		*/
+		using SampleCallback = std::function<void(const float* samples, const size_t count)>;
+
+		ISTFT() = delete;
+		/**
+		* Constructs an ISTFT. Use the same parameters as the STFT that produced the frames.
+		*
+		* @param N Frame length in samples, also the DFT size.
+		* @param hop Number of samples between the starts of two consecutive frames, in [1, N]. The window must overlap-add to a non-zero sum at that hop.
+		* @param window Window applied to the frames after their inverse DFT.
+		* @param padStart Whether the frames come from an STFT that padded its start, in which case the N - hop first output samples are that padding and get dropped. Without it, the first N - hop samples aren't covered by enough frames and come out faded in, and the last N - hop ones never get completed.
+		*/
+		ISTFT(const unsigned int N, const unsigned int hop, const WindowType window = WindowType::Hann, const bool padStart = true);
+
+		/**
+		* Adds a spectral frame to the output, calling onSamples with the samples it completes. Does not allocate.
+		*
+		* @param spectrum Bins 0 to N/2 of the frame.
+		* @param onSamples Function receiving the completed samples, in order.
+		*/
+		void PushFrame(const std::vector<std::complex<float>>& spectrum, const SampleCallback& onSamples);
+
+		/**
+		* Forgets every pushed frame, as if the ISTFT was just constructed.
+		*/
+		void Reset();
+
+		const unsigned int N; // Frame length.
+		const unsigned int hop; // Samples between consecutive frames.
+		const bool padStart; // Whether the frames come from an STFT that padded its start.
+
+	private:
+		Plan plan_; // Inverse plan from bins 0 to N/2.
+		std::vector<float> window_;
+		std::vector<float> inverseNorm_; // 1 / sum over m of window[n + m*hop]^2, for n < hop.
+		std::vector<float> accumulator_; // Overlap-added samples, ring of N. The oldest one, next to be completed, is at readPos_.
+		std::vector<float> frame_; // Inverse DFT of the last frame.
+		std::vector<float> out_; // Completed samples handed to the callback.
+		size_t readPos_ = 0; // Oldest sample of accumulator_.
+		size_t toDrop_ = 0; // Samples of start padding still to drop from the output.
+	};
+}
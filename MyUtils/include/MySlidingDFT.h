@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+#include "MyDFTPlan.h"
+
+namespace MyDFT
+{
+	/**
+	* Sliding Discrete Fourier Transform. Keeps the first K bins of the DFT of the last N samples of a stream, and updates them for every new sample in O(K) instead of recomputing an O(N log N) transform: X[k] = r * e^(i*2*PI*k/N) * (X[k] + x[n] - r^N * x[n-N]).
+	* The update is a recursion, so rounding errors pile up and an undamped one sits right on the unit circle. The damping factor r pulls the poles inside it so that errors die out, at the cost of weighting the window: sample m of the window, oldest first, is multiplied by r^(N-m).
+	* Every resyncInterval samples the bins are recomputed from scratch with a full transform of the same weighted window, which puts a hard bound on the drift.
+	* The bins are updated side by side in the SIMD lanes of MyDFTKernels.h. Memory stays constant, the last N samples live in a ring buffer.
+	*/
+	class SlidingDFT
+	{
+	public:
+		SlidingDFT() = delete;
+		/**
+		* Constructs a SlidingDFT. The window starts out full of zeros.
+		*
+		* @param N Window length in samples, also the DFT size.
+		* @param K Number of bins kept, bins 0 to K-1. Use K = N/2+1 for the whole non-redundant spectrum.
+		* @param damping Damping factor r of the recursion, in (0, 1]. 1 computes the plain DFT of the window but relies on resynchronization alone against drift.
+		* @param resyncInterval Samples between two resynchronizations against a full transform, 0 to never resynchronize.
+		*/
+		SlidingDFT(const unsigned int N, const unsigned int K, const float damping = DEFAULT_DAMPING, const size_t resyncInterval = DEFAULT_RESYNC_INTERVAL);
+
+		/**
+		* Slides the window by one sample.
+		*
+		* @param sample Newest sample of the stream.
+		*/
+		void Update(const float sample);
+
+		/**
+		* Slides the window by count samples, O(K * count). Does not allocate.
+		*
+		* @param samples Buffer of count samples.
+		* @param count Number of samples, any value.
+		*/
+		void Update(const float* samples, const size_t count);
+
+		/**
+		* Overload of Update() for a whole buffer.
+		*/
+		void Update(const std::vector<float>& samples);
+
+		/**
+		* Returns the bins of the window of the last N samples: out[k] = sum_m(r^(N-m) * x[m] * e^(-i*2*PI*k*m/N)), m = 0 being the oldest sample.
+		*
+		* @param out Output bins. Resized to K by the function.
+		*/
+		void GetSpectrum(std::vector<std::complex<float>>& out) const;
+
+		/**
+		* Recomputes the bins from the window with a full transform, discarding the error accumulated by the recursion. Called every resyncInterval samples by Update().
+		*/
+		void Resync();
+
+		/**
+		* Empties the window, as if the SlidingDFT was just constructed.
+		*/
+		void Reset();
+
+		static constexpr float DEFAULT_DAMPING = 0.99999f; // Attenuates the oldest sample of a 1024-point window by about 1%.
+		static constexpr size_t DEFAULT_RESYNC_INTERVAL = 65536; // About one and a half second at 44.1kHz.
+
+		const unsigned int N; // Window length.
+		const unsigned int K; // Number of bins.
+		const float damping; // Damping factor r.
+		const size_t resyncInterval; // Samples between resynchronizations, 0 for never.
+
+	private:
+		Plan plan_; // N-point forward plan computing the K bins, for resynchronizations.
+		const Kernels::KernelTable& kernels_;
+		std::vector<float> twiddlesRe_; // r * e^(i*2*PI*k/N) for k < K, split format.
+		std::vector<float> twiddlesIm_;
+		std::vector<float> binsRe_; // Current bins, split format.
+		std::vector<float> binsIm_;
+		std::vector<float> weights_; // r^(N-m) for m < N, the weighting of the window.
+		std::vector<float> ring_; // Last N samples. The oldest one is at writePos_.
+		std::vector<float> deltas_; // x[n] - r^N * x[n-N] of the samples being pushed.
+		std::vector<float> frame_; // Weighted window handed to the plan.
+		std::vector<std::complex<float>> spectrum_; // Bins computed by the plan.
+		float dampingN_; // r^N, the weight of the sample leaving the window.
+		size_t writePos_ = 0; // Where the next sample goes in ring_.
+		size_t untilResync_ = 0; // Samples left to push before the next resynchronization.
+	};
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace MyUtils
+{
+	constexpr size_t CACHE_LINE_SIZE = 64; // Bytes. Data written by different threads is kept this far apart to avoid false sharing.
+
+	/**
+	* Wait-free single-producer/single-consumer ring of preallocated slots, to hand data from one thread to another without locks nor allocations, e.g. to a real-time audio callback.
+	* The slots are written and read in place: the producer fills the slot returned by BeginWrite() and publishes it with EndWrite(), the consumer reads the slot returned by BeginRead() and frees it with EndRead().
+	* Each side owns its index on a cache line of its own, along with its last known copy of the other side's index, so that the two threads only touch each other's cache line when the ring looks full or empty.
+	* Exactly one thread may write and one thread may read at any given time.
+	*/
+	template<class T>
+	class SpscRing
+	{
+	public:
+		SpscRing() = delete;
+		/**
+		* Constructs a SpscRing, all of its slots copied from prototype so that they're allocated upfront.
+		*
+		* @param capacity Number of slots, at least 1.
+		* @param prototype Value the slots start with.
+		*/
+		SpscRing(const size_t capacity, const T& prototype = T()): slots_(capacity, prototype) {}
+		SpscRing(const SpscRing&) = delete;
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		/**
+		* Producer side. Returns the next free slot, to be filled then published with EndWrite().
+		*
+		* @return The slot, nullptr if the ring is full.
+		*/
+		T* BeginWrite()
+		{
+			const size_t write = producer_.index.load(std::memory_order_relaxed);
+			if (write - producer_.otherIndex == slots_.size())
+			{
+				producer_.otherIndex = consumer_.index.load(std::memory_order_acquire);
+				if (write - producer_.otherIndex == slots_.size()) return nullptr;
+			}
+			return &slots_[write % slots_.size()];
+		}
+
+		/**
+		* Producer side. Publishes the slot returned by the last BeginWrite() to the consumer.
+		*/
+		void EndWrite()
+		{
+			producer_.index.store(producer_.index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/**
+		* Consumer side. Returns the oldest published slot, to be freed with EndRead() once read.
+		*
+		* @return The slot, nullptr if the ring is empty.
+		*/
+		T* BeginRead()
+		{
+			const size_t read = consumer_.index.load(std::memory_order_relaxed);
+			if (read == consumer_.otherIndex)
+			{
+				consumer_.otherIndex = producer_.index.load(std::memory_order_acquire);
+				if (read == consumer_.otherIndex) return nullptr;
+			}
+			return &slots_[read % slots_.size()];
+		}
+
+		/**
+		* Consumer side. Frees the slot returned by the last BeginRead() for the producer to reuse.
+		*/
+		void EndRead()
+		{
+			consumer_.index.store(consumer_.index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		/**
+		* Returns the number of published slots not yet freed by the consumer. Any thread may call it, the count may be stale by the time it returns.
+		*/
+		size_t GetCount() const
+		{
+			const size_t read = consumer_.index.load(std::memory_order_acquire);
+			return producer_.index.load(std::memory_order_acquire) - read;
+		}
+
+		/**
+		* Returns the number of slots.
+		*/
+		size_t GetCapacity() const
+		{
+			return slots_.size();
+		}
+
+	private:
+		// Index written by one side and the other side's index as last seen by it. Indices only grow, slot i % capacity being the one they point to.
+		struct alignas(CACHE_LINE_SIZE) Side
+		{
+			std::atomic<size_t> index = 0;
+			size_t otherIndex = 0;
+		};
+
+		std::vector<T> slots_;
+		Side producer_;
+		Side consumer_;
+	};
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace MyUtils
+{
+	/**
+	* Work-stealing thread pool. Every worker owns a task queue: it runs its own tasks newest first (they're the most likely to still be in cache) and steals the oldest tasks of the other workers when its queue runs dry.
+	* Threads calling ParallelFor() help executing tasks while they wait, so parallel loops can be nested without deadlocking.
+	*/
+	class ThreadPool
+	{
+	public:
+		/**
+		* Constructs a ThreadPool and starts its workers.
+		*
+		* @param threadCount Number of worker threads. 0 uses one per hardware thread.
+		*/
+		explicit ThreadPool(const unsigned int threadCount = 0);
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		* Waits for the queued tasks to finish and joins the workers.
+		*/
+		~ThreadPool();
+
+		/**
+		* Queues a task. Tasks submitted from a worker go to that worker's queue, others are distributed round-robin.
+		*
+		* @param task Function to execute on one of the workers.
+		*/
+		void Submit(std::function<void()> task);
+
+		/**
+		* Splits [begin, end) into chunks of at least grain indices and runs body(chunkBegin, chunkEnd) on each, in parallel. Blocks until all chunks are done, the calling thread executes chunks as well.
+		* If a chunk throws, the first exception is rethrown on the calling thread once every chunk finished.
+		*
+		* @param begin First index.
+		* @param end One past the last index.
+		* @param grain Minimum number of indices per chunk, to keep the scheduling overhead small compared to the work.
+		* @param body Function called with the bounds of each chunk.
+		*/
+		void ParallelFor(const size_t begin, const size_t end, const size_t grain, const std::function<void(size_t, size_t)>& body);
+
+		/**
+		* Returns the number of worker threads.
+		*/
+		unsigned int GetThreadCount() const;
+
+	private:
+		struct Queue
+		{
+			std::mutex m;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		/**
+		* Runs one queued task, taken from queue first or stolen from the other ones.
+		*
+		* @return False if all the queues were empty.
+		*/
+		bool TryRunOne_(const size_t first);
+
+		void WorkerLoop_(const size_t index);
+
+		std::vector<std::unique_ptr<Queue>> queues_; // One per worker.
+		std::vector<std::thread> threads_;
+		std::mutex sleepMutex_; // Guards the wake-ups of idle workers.
+		std::condition_variable sleepCv_;
+		std::atomic<size_t> pending_ = 0; // Number of queued tasks not yet started.
+		std::atomic<size_t> nextQueue_ = 0; // Round-robin counter for tasks submitted from outside the pool.
+		bool stop_ = false; // Guarded by sleepMutex_.
+	};
+}
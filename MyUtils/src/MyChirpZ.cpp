@@ -0,0 +1,135 @@
+#include "MyChirpZ.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+
+#include "MyMath.h"
+
+// e^(i*angle*n^2/2), the phase reduced in double precision before the conversion since n^2 gets large.
+static std::complex<double> Chirp(const double angle, const size_t n)
+{
+	const double phase = std::fmod(angle * 0.5 * (double)n * (double)n, 2.0 * MyMath::PI_D);
+	return std::polar(1.0, phase);
+}
+
+MyDFT::ChirpZ::ChirpZ(const unsigned int N, const unsigned int K, const double startAngle, const double stepAngle):
+	N(N), K(K), startAngle(startAngle), stepAngle(stepAngle), forward_(SmoothLength(N + K - 1), Direction::Forward), inverse_(forward_.length, Direction::Inverse),
+	inputChirpRe_(N), inputChirpIm_(N), outputChirpRe_(K), outputChirpIm_(K), filterRe_(forward_.length, 0.0f), filterIm_(forward_.length, 0.0f), workRe_(forward_.length), workIm_(forward_.length)
+{
+	assert(N > 0 && K > 0 && "Cannot transform an empty signal.");
+
+	const size_t L = forward_.length;
+	for (size_t n = 0; n < N; ++n)
+	{
+		const double phase = std::fmod(startAngle * (double)n, 2.0 * MyMath::PI_D);
+		const std::complex<double> chirp = std::conj(Chirp(stepAngle, n)) * std::polar(1.0, -phase);
+		inputChirpRe_[n] = (float)chirp.real();
+		inputChirpIm_[n] = (float)chirp.imag();
+	}
+	for (size_t k = 0; k < K; ++k)
+	{
+		const std::complex<double> chirp = std::conj(Chirp(stepAngle, k));
+		outputChirpRe_[k] = (float)chirp.real();
+		outputChirpIm_[k] = (float)chirp.imag();
+	}
+
+	// Output k needs the filter at k-n for every n < N. L >= N+K-1 keeps the negative indices, wrapped to the end, from overlapping the positive ones.
+	const double scale = 1.0 / (double)L;
+	for (size_t j = 0; j < std::max(N, K); ++j)
+	{
+		const std::complex<double> chirp = Chirp(stepAngle, j) * scale;
+		if (j < K)
+		{
+			filterRe_[j] = (float)chirp.real();
+			filterIm_[j] = (float)chirp.imag();
+		}
+		if (j > 0 && j < N)
+		{
+			filterRe_[L - j] = (float)chirp.real();
+			filterIm_[L - j] = (float)chirp.imag();
+		}
+	}
+	forward_.TransformSplit(filterRe_.data(), filterIm_.data());
+}
+
+void MyDFT::ChirpZ::Execute(std::vector<std::complex<float>>& out, const std::vector<float>& x, MyUtils::ThreadPool* pool)
+{
+	assert(x.size() == N && out.size() >= K && "Mismatching buffer sizes.");
+
+	// The output is first written split into the work buffers, which the convolution is done with by then.
+	ExecuteSplit(workRe_.data(), workIm_.data(), x.data(), nullptr, pool);
+	for (size_t k = 0; k < K; ++k)
+	{
+		out[k] = std::complex<float>(workRe_[k], workIm_[k]);
+	}
+}
+
+void MyDFT::ChirpZ::ExecuteSplit(float* outRe, float* outIm, const float* inRe, const float* inIm, MyUtils::ThreadPool* pool)
+{
+	const size_t L = forward_.length;
+	for (size_t n = 0; n < N; ++n)
+	{
+		const float re = inRe[n];
+		const float im = inIm ? inIm[n] : 0.0f;
+		workRe_[n] = re * inputChirpRe_[n] - im * inputChirpIm_[n];
+		workIm_[n] = re * inputChirpIm_[n] + im * inputChirpRe_[n];
+	}
+	std::fill(workRe_.begin() + N, workRe_.end(), 0.0f);
+	std::fill(workIm_.begin() + N, workIm_.end(), 0.0f);
+
+	forward_.TransformSplit(workRe_.data(), workIm_.data(), pool);
+	for (size_t i = 0; i < L; ++i)
+	{
+		const float re = workRe_[i];
+		const float im = workIm_[i];
+		workRe_[i] = re * filterRe_[i] - im * filterIm_[i];
+		workIm_[i] = re * filterIm_[i] + im * filterRe_[i];
+	}
+	inverse_.TransformSplit(workRe_.data(), workIm_.data(), pool);
+
+	for (size_t k = 0; k < K; ++k)
+	{
+		const float re = workRe_[k];
+		const float im = workIm_[k];
+		outRe[k] = re * outputChirpRe_[k] - im * outputChirpIm_[k];
+		outIm[k] = re * outputChirpIm_[k] + im * outputChirpRe_[k];
+	}
+}
+
+unsigned int MyDFT::ChirpZ::SmoothLength(const unsigned int minLength)
+{
+	for (unsigned int length = std::max(minLength, 1u);; ++length)
+	{
+		unsigned int n = length;
+		for (const unsigned int p : {2u, 3u, 5u})
+		{
+			while (n % p == 0) n /= p;
+		}
+		if (n == 1) return length;
+	}
+}
+
+void MyDFT::ZoomDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int K, const double f0, const double f1, const double sampleRate)
+{
+	assert(sampleRate > 0.0 && "Invalid sampling rate.");
+
+	out.resize(K);
+	if (K == 0) return;
+	if (x.empty())
+	{
+		std::fill(out.begin(), out.end(), std::complex<float>(0.0f, 0.0f));
+		return;
+	}
+
+	const double step = (K > 1) ? (f1 - f0) / (double)(K - 1) : 0.0;
+	ChirpZ chirpZ((unsigned int)x.size(), K, 2.0 * MyMath::PI_D * f0 / sampleRate, 2.0 * MyMath::PI_D * step / sampleRate);
+	chirpZ.Execute(out, x);
+}
+
+std::vector<std::complex<float>> MyDFT::ZoomDFT(const std::vector<float>& x, const unsigned int K, const double f0, const double f1, const double sampleRate)
+{
+	std::vector<std::complex<float>> out;
+	ZoomDFT(out, x, K, f0, f1, sampleRate);
+	return out;
+}
@@ -0,0 +1,210 @@
+#include "MyConvolution.h"
+
+#include <cassert>
+#include <algorithm>
+
+MyDFT::PartitionedConvolver::PartitionedConvolver(const std::vector<float>& impulseResponse, const unsigned int blockSize):
+	blockSize(blockSize), partitionCount(std::max((size_t)1, (impulseResponse.size() + blockSize - 1) / blockSize)),
+	forward_(2 * blockSize, blockSize + 1, Direction::Forward), inverse_(2 * blockSize, blockSize + 1, Direction::Inverse), kernels_(Kernels::GetKernels()),
+	input_(2 * (size_t)blockSize, 0.0f), output_(2 * (size_t)blockSize, 0.0f), spectrum_((size_t)blockSize + 1)
+{
+	assert(blockSize > 0 && "Cannot process empty blocks.");
+
+	const size_t bins = (size_t)blockSize + 1;
+	partitionsRe_.resize(partitionCount * bins);
+	partitionsIm_.resize(partitionCount * bins);
+	delayLineRe_.resize(partitionCount * bins);
+	delayLineIm_.resize(partitionCount * bins);
+	accumulatorRe_.resize(bins);
+	accumulatorIm_.resize(bins);
+
+	// Each partition goes in the first half of its transform, the zeros of the second half keep the circular convolution from wrapping onto the samples we keep.
+	std::vector<float> partition(2 * (size_t)blockSize, 0.0f);
+	for (size_t p = 0; p < partitionCount; ++p)
+	{
+		std::fill(partition.begin(), partition.end(), 0.0f);
+		const size_t begin = std::min(impulseResponse.size(), p * blockSize);
+		const size_t end = std::min(impulseResponse.size(), begin + blockSize);
+		std::copy(impulseResponse.begin() + begin, impulseResponse.begin() + end, partition.begin());
+
+		forward_.Execute(spectrum_, partition);
+		for (size_t k = 0; k < bins; ++k)
+		{
+			partitionsRe_[p * bins + k] = spectrum_[k].real();
+			partitionsIm_[p * bins + k] = spectrum_[k].imag();
+		}
+	}
+}
+
+void MyDFT::PartitionedConvolver::Process(float* block)
+{
+	const size_t bins = (size_t)blockSize + 1;
+
+	// Overlap-save: transform the previous block followed by the current one.
+	std::copy(input_.begin() + blockSize, input_.end(), input_.begin());
+	std::copy(block, block + blockSize, input_.begin() + blockSize);
+	forward_.Execute(spectrum_, input_);
+
+	delayLinePos_ = (delayLinePos_ + partitionCount - 1) % partitionCount;
+	float* newestRe = delayLineRe_.data() + delayLinePos_ * bins;
+	float* newestIm = delayLineIm_.data() + delayLinePos_ * bins;
+	for (size_t k = 0; k < bins; ++k)
+	{
+		newestRe[k] = spectrum_[k].real();
+		newestIm[k] = spectrum_[k].imag();
+	}
+
+	// Partition p of the impulse response meets the input from p blocks ago.
+	std::fill(accumulatorRe_.begin(), accumulatorRe_.end(), 0.0f);
+	std::fill(accumulatorIm_.begin(), accumulatorIm_.end(), 0.0f);
+	for (size_t p = 0; p < partitionCount; ++p)
+	{
+		const size_t slot = (delayLinePos_ + p) % partitionCount;
+		kernels_.multiplyAccumulate(delayLineRe_.data() + slot * bins, delayLineIm_.data() + slot * bins, partitionsRe_.data() + p * bins, partitionsIm_.data() + p * bins, accumulatorRe_.data(), accumulatorIm_.data(), bins);
+	}
+
+	for (size_t k = 0; k < bins; ++k)
+	{
+		spectrum_[k] = std::complex<float>(accumulatorRe_[k], accumulatorIm_[k]);
+	}
+	inverse_.ExecuteHermitian(output_, spectrum_);
+
+	// The first half wrapped around the circular convolution, the second half is the linear one.
+	std::copy(output_.begin() + blockSize, output_.end(), block);
+}
+
+void MyDFT::PartitionedConvolver::Process(std::vector<float>& block)
+{
+	assert(block.size() == blockSize && "Blocks must hold blockSize samples.");
+	Process(block.data());
+}
+
+void MyDFT::PartitionedConvolver::Reset()
+{
+	std::fill(input_.begin(), input_.end(), 0.0f);
+	std::fill(delayLineRe_.begin(), delayLineRe_.end(), 0.0f);
+	std::fill(delayLineIm_.begin(), delayLineIm_.end(), 0.0f);
+	delayLinePos_ = 0;
+}
+
+// Slice [begin, end) of an impulse response, clamped to its length.
+static std::vector<float> Slice(const std::vector<float>& impulseResponse, const size_t begin, const size_t end)
+{
+	const size_t first = std::min(begin, impulseResponse.size());
+	const size_t last = std::min(end, impulseResponse.size());
+	return std::vector<float>(impulseResponse.begin() + first, impulseResponse.begin() + last);
+}
+
+MyDFT::NonUniformConvolver::Segment::Segment(const std::vector<float>& impulseResponse, const unsigned int partitionSize):
+	convolver(impulseResponse, partitionSize), input(partitionSize, 0.0f), work(partitionSize, 0.0f), ready(partitionSize, 0.0f) {}
+
+MyDFT::NonUniformConvolver::NonUniformConvolver(const std::vector<float>& impulseResponse, const unsigned int blockSize, const bool background, const unsigned int maxPartitionSize):
+	blockSize(blockSize), head_(Slice(impulseResponse, 0, (maxPartitionSize >= 2 * blockSize) ? 4 * (size_t)blockSize : impulseResponse.size()), blockSize), dry_(blockSize, 0.0f)
+{
+	assert(blockSize > 0 && "Cannot process empty blocks.");
+
+	// Segment of partitions of size Bs starts at tap 2*Bs and, unless it's the last, ends where the next one starts, at 4*Bs.
+	size_t offset = (maxPartitionSize >= 2 * blockSize) ? 4 * (size_t)blockSize : impulseResponse.size();
+	size_t size = blockSize;
+	while (offset < impulseResponse.size())
+	{
+		size *= 2;
+		const bool last = size * 2 > maxPartitionSize;
+		const size_t end = last ? impulseResponse.size() : 4 * size;
+		segments_.push_back(std::make_unique<Segment>(Slice(impulseResponse, offset, end), (unsigned int)size));
+		offset = end;
+	}
+
+	if (background && !segments_.empty()) worker_ = std::thread(&NonUniformConvolver::WorkerLoop_, this);
+}
+
+MyDFT::NonUniformConvolver::~NonUniformConvolver()
+{
+	if (!worker_.joinable()) return;
+	// Joined before any segment is freed. The blocks it was handed but didn't start are dropped, nobody waits for their output anymore.
+	stop_.store(true, std::memory_order_release);
+	wake_.release();
+	worker_.join();
+}
+
+void MyDFT::NonUniformConvolver::Process(float* block)
+{
+	std::copy(block, block + blockSize, dry_.begin());
+	head_.Process(block);
+
+	for (auto& segmentPtr : segments_)
+	{
+		Segment& segment = *segmentPtr;
+		const size_t size = segment.input.size();
+		const size_t phase = position_ % size;
+
+		// ready holds the convolution of the block before last: the segment starts at tap 2*size, so that's exactly the output due now.
+		for (size_t i = 0; i < blockSize; ++i)
+		{
+			block[i] += segment.ready[phase + i];
+		}
+		std::copy(dry_.begin(), dry_.end(), segment.input.begin() + phase);
+
+		if (phase + blockSize < size) continue;
+
+		// A block of input is complete. The previous one had a whole block of time to get convolved, its output is due from the next call on.
+		Wait_(segment);
+		std::swap(segment.ready, segment.work);
+		std::swap(segment.work, segment.input);
+		if (!worker_.joinable())
+		{
+			segment.convolver.Process(segment.work.data());
+			continue;
+		}
+		segment.busy.store(true, std::memory_order_relaxed);
+		wake_.release(); // Publishes work to the worker.
+	}
+
+	position_ += blockSize;
+}
+
+void MyDFT::NonUniformConvolver::Process(std::vector<float>& block)
+{
+	assert(block.size() == blockSize && "Blocks must hold blockSize samples.");
+	Process(block.data());
+}
+
+void MyDFT::NonUniformConvolver::Reset()
+{
+	head_.Reset();
+	for (auto& segment : segments_)
+	{
+		Wait_(*segment);
+		segment->convolver.Reset();
+		std::fill(segment->input.begin(), segment->input.end(), 0.0f);
+		std::fill(segment->work.begin(), segment->work.end(), 0.0f); // Holds the last convolution, it would become ready at the next complete block.
+		std::fill(segment->ready.begin(), segment->ready.end(), 0.0f);
+	}
+	position_ = 0;
+}
+
+size_t MyDFT::NonUniformConvolver::GetSegmentCount() const
+{
+	return segments_.size() + 1;
+}
+
+void MyDFT::NonUniformConvolver::Wait_(Segment& segment)
+{
+	segment.busy.wait(true, std::memory_order_acquire);
+}
+
+void MyDFT::NonUniformConvolver::WorkerLoop_()
+{
+	while (true)
+	{
+		wake_.acquire();
+		for (auto& segment : segments_)
+		{
+			if (!segment->busy.load(std::memory_order_acquire)) continue;
+			segment->convolver.Process(segment->work.data());
+			segment->busy.store(false, std::memory_order_release);
+			segment->busy.notify_one();
+		}
+		if (stop_.load(std::memory_order_acquire)) return;
+	}
+}
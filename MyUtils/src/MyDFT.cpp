@@ -2,15 +2,322 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cassert>
 
 #include "MyMath.h"
+#include "MyOscillatorBank.h"
 
 static std::complex<float> EulersFormula(const float x)
 {
 	return std::complex<float>(std::cosf(x), std::sinf(x));
 }
 
+void MyDFT::FFT(std::vector<std::complex<float>>& out, const std::vector<std::complex<float>>& x)
+{
+	const unsigned int N = (unsigned int)x.size();
+	out.resize(N);
+	if (N == 0) return;
+
+	GetPlan(N, N, Direction::Forward)->ExecuteComplex(out.data(), x.data());
+}
+
+void MyDFT::IFFT(std::vector<std::complex<float>>& out, const std::vector<std::complex<float>>& y)
+{
+	const unsigned int N = (unsigned int)y.size();
+	out.resize(N);
+	if (N == 0) return;
+
+	GetPlan(N, N, Direction::Inverse)->ExecuteComplex(out.data(), y.data());
+
+	const float scale = 1.0f / (float)N;
+	for (auto& sample : out)
+	{
+		sample *= scale;
+	}
+}
+
+void MyDFT::FFT(std::vector<std::complex<float>>& out, const std::vector<std::complex<float>>& x, MyUtils::ThreadPool& pool)
+{
+	const unsigned int N = (unsigned int)x.size();
+	out.resize(N);
+	if (N == 0) return;
+
+	GetPlan(N, N, Direction::Forward)->ExecuteComplex(out.data(), x.data(), &pool);
+}
+
+void MyDFT::IFFT(std::vector<std::complex<float>>& out, const std::vector<std::complex<float>>& y, MyUtils::ThreadPool& pool)
+{
+	const unsigned int N = (unsigned int)y.size();
+	out.resize(N);
+	if (N == 0) return;
+
+	GetPlan(N, N, Direction::Inverse)->ExecuteComplex(out.data(), y.data(), &pool);
+
+	const float scale = 1.0f / (float)N;
+	for (auto& sample : out)
+	{
+		sample *= scale;
+	}
+}
+
+bool MyDFT::IsFastSize(unsigned int N)
+{
+	if (N == 0) return false;
+	for (const unsigned int p : { 2u, 3u, 5u })
+	{
+		while (N % p == 0) N /= p;
+	}
+	return N == 1;
+}
+
 void MyDFT::DFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int K, const bool printProgress)
+{
+	assert(out.size() >= K && "Output buffer too small.");
+
+	const unsigned int N = (unsigned int)x.size();
+	std::vector<std::complex<float>>& y = out;
+
+	std::fill(y.begin(), y.end(), std::complex<float>(0.0f, 0.0f));
+	if (N == 0) return;
+
+	GetPlan(N, K, Direction::Forward)->Execute(y, x);
+
+	if (printProgress) std::cout << "DFT done." << std::endl;
+}
+
+std::vector<std::complex<float>> MyDFT::DFT(const std::vector<float>& x, const unsigned int K, const bool printProgress)
+{
+	std::vector<std::complex<float>> y(K, std::complex<float>(0.0f, 0.0f));
+	DFT(y, x, K, printProgress);
+	return y;
+}
+
+void MyDFT::IDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress)
+{
+	assert(out.size() >= N && "Output buffer too small.");
+
+	std::vector<float>& x = out;
+
+	std::fill(x.begin(), x.end(), 0.0f);
+	if (N == 0) return;
+
+	GetPlan(N, (unsigned int)y.size(), Direction::Inverse)->Execute(x, y);
+	for (unsigned int n = 0; n < N; ++n)
+	{
+		x[n] = std::clamp(x[n], -1.0f, 1.0f); // Out-of-bounds samples can be generated even with correct N due to float imprecision which results in crackling when played back by a device that expects a normalized PCM.
+	}
+
+	if (printProgress) std::cout << "IDFT done." << std::endl;
+}
+
+std::vector<float> MyDFT::IDFT(const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress)
+{
+	std::vector<float> x(N, 0.0f);
+	if (N == 0) return x;
+
+	GetPlan(N, (unsigned int)y.size(), Direction::Inverse)->Execute(x, y);
+
+	if (printProgress) std::cout << "IDFT done." << std::endl;
+
+	return x;
+}
+
+// x[n] = 1/N * sum(Re(value * e^(i*2*PI*k*n/N))), an oscillator at frequency k for a sampling rate of N.
+static void SynthesizeSparse(std::vector<float>& x, const MyDFT::SparseSpectrum& y, const unsigned int N)
+{
+	std::vector<float> frequencies(y.size());
+	std::vector<std::complex<float>> amplitudes(y.size());
+	for (size_t j = 0; j < y.size(); ++j)
+	{
+		frequencies[j] = (float)(y[j].k % N);
+		amplitudes[j] = y[j].value / (float)N;
+	}
+	MyDFT::OscillatorBank bank(frequencies, amplitudes, (float)N);
+	bank.Render(x.data(), N);
+}
+
+MyDFT::SparseSpectrum MyDFT::MakeSparseSpectrum(const std::vector<std::complex<float>>& y, const float threshold)
+{
+	SparseSpectrum sparse;
+	for (unsigned int k = 0; k < (unsigned int)y.size(); ++k)
+	{
+		if (std::norm(y[k]) > threshold * threshold) sparse.push_back({ k, y[k] });
+	}
+	return sparse;
+}
+
+void MyDFT::IDFT(std::vector<float>& out, const SparseSpectrum& y, const unsigned int N, const bool printProgress)
+{
+	assert(out.size() >= N && "Output buffer too small.");
+
+	std::vector<float>& x = out;
+
+	std::fill(x.begin(), x.end(), 0.0f);
+	if (N == 0) return;
+
+	SynthesizeSparse(x, y, N);
+	for (unsigned int n = 0; n < N; ++n)
+	{
+		x[n] = std::clamp(x[n], -1.0f, 1.0f); // Same as the dense IDFT().
+	}
+
+	if (printProgress) std::cout << "IDFT done." << std::endl;
+}
+
+std::vector<float> MyDFT::IDFT(const SparseSpectrum& y, const unsigned int N, const bool printProgress)
+{
+	std::vector<float> x(N, 0.0f);
+	if (N == 0) return x;
+
+	SynthesizeSparse(x, y, N);
+
+	if (printProgress) std::cout << "IDFT done." << std::endl;
+
+	return x;
+}
+
+void MyDFT::DFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int K, MyUtils::ThreadPool& pool, const bool printProgress)
+{
+	assert(out.size() >= K && "Output buffer too small.");
+
+	const unsigned int N = (unsigned int)x.size();
+	std::vector<std::complex<float>>& y = out;
+
+	std::fill(y.begin(), y.end(), std::complex<float>(0.0f, 0.0f));
+	if (N == 0) return;
+
+	GetPlan(N, K, Direction::Forward)->Execute(y, x, &pool);
+
+	if (printProgress) std::cout << "DFT done." << std::endl;
+}
+
+std::vector<std::complex<float>> MyDFT::DFT(const std::vector<float>& x, const unsigned int K, MyUtils::ThreadPool& pool, const bool printProgress)
+{
+	std::vector<std::complex<float>> y(K, std::complex<float>(0.0f, 0.0f));
+	DFT(y, x, K, pool, printProgress);
+	return y;
+}
+
+void MyDFT::IDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, MyUtils::ThreadPool& pool, const bool printProgress)
+{
+	assert(out.size() >= N && "Output buffer too small.");
+
+	std::vector<float>& x = out;
+
+	std::fill(x.begin(), x.end(), 0.0f);
+	if (N == 0) return;
+
+	GetPlan(N, (unsigned int)y.size(), Direction::Inverse)->Execute(x, y, &pool);
+	for (unsigned int n = 0; n < N; ++n)
+	{
+		x[n] = std::clamp(x[n], -1.0f, 1.0f); // Same as the single-threaded IDFT().
+	}
+
+	if (printProgress) std::cout << "IDFT done." << std::endl;
+}
+
+std::vector<float> MyDFT::IDFT(const std::vector<std::complex<float>>& y, const unsigned int N, MyUtils::ThreadPool& pool, const bool printProgress)
+{
+	std::vector<float> x(N, 0.0f);
+	if (N == 0) return x;
+
+	GetPlan(N, (unsigned int)y.size(), Direction::Inverse)->Execute(x, y, &pool);
+
+	if (printProgress) std::cout << "IDFT done." << std::endl;
+
+	return x;
+}
+
+// Number of frames handed to each worker by the multithreaded batched transforms: whole SIMD groups, enough samples to amortize the scheduling.
+static size_t BatchGrain(const unsigned int N, const size_t lanes)
+{
+	const size_t frames = std::max((size_t)1, (size_t)MyDFT::FFTEngine::PARALLEL_MIN_LENGTH / ((size_t)N * 4));
+	return (frames + lanes - 1) / lanes * lanes;
+}
+
+void MyDFT::BatchedDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int N, const unsigned int K)
+{
+	assert(N > 0 && x.size() % N == 0 && "The batch must hold a whole number of frames.");
+
+	const size_t count = x.size() / N;
+	out.resize(count * K);
+	if (count == 0 || K == 0) return;
+
+	GetPlan(N, K, Direction::Forward)->ExecuteBatch(out.data(), x.data(), count);
+}
+
+void MyDFT::BatchedDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int N, const unsigned int K, MyUtils::ThreadPool& pool)
+{
+	assert(N > 0 && x.size() % N == 0 && "The batch must hold a whole number of frames.");
+
+	const size_t count = x.size() / N;
+	out.resize(count * K);
+	if (count == 0 || K == 0) return;
+
+	// Every thread transforms its frames with its own cached Plan.
+	const size_t grain = BatchGrain(N, Kernels::GetKernels().width);
+	const size_t chunks = (count + grain - 1) / grain;
+	pool.ParallelFor(0, chunks, 1, [&](const size_t begin, const size_t end)
+		{
+			const size_t first = begin * grain;
+			const size_t last = std::min(count, end * grain);
+			GetPlan(N, K, Direction::Forward)->ExecuteBatch(out.data() + first * K, x.data() + first * N, last - first);
+		});
+}
+
+void MyDFT::BatchedIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const unsigned int K)
+{
+	assert(K > 0 && y.size() % K == 0 && "The batch must hold a whole number of frames.");
+
+	const size_t count = y.size() / K;
+	out.resize(count * N);
+	if (count == 0 || N == 0) return;
+
+	GetPlan(N, K, Direction::Inverse)->ExecuteBatch(out.data(), y.data(), count);
+}
+
+void MyDFT::BatchedIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const unsigned int K, MyUtils::ThreadPool& pool)
+{
+	assert(K > 0 && y.size() % K == 0 && "The batch must hold a whole number of frames.");
+
+	const size_t count = y.size() / K;
+	out.resize(count * N);
+	if (count == 0 || N == 0) return;
+
+	const size_t grain = BatchGrain(N, Kernels::GetKernels().width);
+	const size_t chunks = (count + grain - 1) / grain;
+	pool.ParallelFor(0, chunks, 1, [&](const size_t begin, const size_t end)
+		{
+			const size_t first = begin * grain;
+			const size_t last = std::min(count, end * grain);
+			GetPlan(N, K, Direction::Inverse)->ExecuteBatch(out.data() + first * N, y.data() + first * K, last - first);
+		});
+}
+
+void MyDFT::RealDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x)
+{
+	const unsigned int N = (unsigned int)x.size();
+	if (N == 0)
+	{
+		out.clear();
+		return;
+	}
+
+	out.resize(N / 2 + 1);
+	GetPlan(N, N / 2 + 1, Direction::Forward)->Execute(out, x);
+}
+
+void MyDFT::RealIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N)
+{
+	assert(y.size() == N / 2 + 1 && "A real-valued signal of N samples has N/2+1 non-redundant bins.");
+
+	out.resize(N);
+	if (N == 0) return;
+
+	GetPlan(N, N / 2 + 1, Direction::Inverse)->ExecuteHermitian(out, y);
+}
+
+void MyDFT::NaiveDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int K, const bool printProgress)
 {
 	const auto PrintProgress = [](const unsigned int k, const unsigned int K)->void
 	{
@@ -40,7 +347,7 @@ void MyDFT::DFT(std::vector<std::complex<float>>& out, const std::vector<float>&
 	if (printProgress) std::cout << "DFT done." << std::endl;
 }
 
-std::vector<std::complex<float>> MyDFT::DFT(const std::vector<float>& x, const unsigned int K, const bool printProgress)
+std::vector<std::complex<float>> MyDFT::NaiveDFT(const std::vector<float>& x, const unsigned int K, const bool printProgress)
 {
 	const auto PrintProgress = [](const unsigned int k, const unsigned int K)->void
 	{
@@ -71,7 +378,7 @@ std::vector<std::complex<float>> MyDFT::DFT(const std::vector<float>& x, const u
 	return y;
 }
 
-void MyDFT::IDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress)
+void MyDFT::NaiveIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress)
 {
 	const auto PrintProgress = [](const unsigned int n, const unsigned int N)->void
 	{
@@ -103,7 +410,7 @@ void MyDFT::IDFT(std::vector<float>& out, const std::vector<std::complex<float>>
 	if (printProgress) std::cout << "IDFT done." << std::endl;
 }
 
-std::vector<float> MyDFT::IDFT(const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress)
+std::vector<float> MyDFT::NaiveIDFT(const std::vector<std::complex<float>>& y, const unsigned int N, const bool printProgress)
 {
 	const auto PrintProgress = [](const unsigned int n, const unsigned int N)->void
 	{
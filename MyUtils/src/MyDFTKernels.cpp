@@ -0,0 +1,107 @@
+#include "MyDFTKernels.h"
+
+#include "MyDFTKernelsImpl.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MYDFT_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#ifdef MYDFT_X86
+static void Cpuid_(unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuidex(r, (int)leaf, (int)subleaf);
+	for (int i = 0; i < 4; ++i) regs[i] = (unsigned int)r[i];
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Which register states the OS saves on context switches. Using registers the OS doesn't save would corrupt them between threads.
+static unsigned long long Xgetbv_()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+#endif
+
+MyDFT::Kernels::InstructionSet MyDFT::Kernels::DetectInstructionSet()
+{
+#ifdef MYDFT_X86
+	unsigned int regs[4]; // eax, ebx, ecx, edx
+	Cpuid_(0, 0, regs);
+	const unsigned int maxLeaf = regs[0];
+	if (maxLeaf < 1) return InstructionSet::Scalar;
+
+	Cpuid_(1, 0, regs);
+	const bool sse2 = (regs[3] >> 26) & 1;
+	const bool fma = (regs[2] >> 12) & 1;
+	const bool osxsave = (regs[2] >> 27) & 1;
+	const bool avx = (regs[2] >> 28) & 1;
+	if (!sse2) return InstructionSet::Scalar;
+	if (!osxsave || !avx || maxLeaf < 7) return InstructionSet::SSE2;
+
+	const unsigned long long xcr0 = Xgetbv_();
+	const bool osYmm = (xcr0 & 0x6) == 0x6; // SSE and AVX states.
+	const bool osZmm = (xcr0 & 0xE6) == 0xE6; // Plus opmask and both halves of the AVX-512 state.
+
+	Cpuid_(7, 0, regs);
+	const bool avx2 = (regs[1] >> 5) & 1;
+	const bool avx512f = (regs[1] >> 16) & 1;
+
+	if (avx512f && osZmm && GetKernelsAVX512_()) return InstructionSet::AVX512;
+	if (avx2 && fma && osYmm && GetKernelsAVX2_()) return InstructionSet::AVX2;
+	if (GetKernelsSSE2_()) return InstructionSet::SSE2;
+#endif
+	return InstructionSet::Scalar;
+}
+
+const MyDFT::Kernels::KernelTable& MyDFT::Kernels::GetKernels()
+{
+	static const KernelTable* const best = GetKernels(DetectInstructionSet());
+	return *best;
+}
+
+const MyDFT::Kernels::KernelTable* MyDFT::Kernels::GetKernels(const InstructionSet instructionSet)
+{
+	static const InstructionSet supported = DetectInstructionSet();
+	if ((int)instructionSet > (int)supported) return nullptr;
+
+	switch (instructionSet)
+	{
+	case InstructionSet::Scalar: return GetKernelsScalar_();
+	case InstructionSet::SSE2: return GetKernelsSSE2_();
+	case InstructionSet::AVX2: return GetKernelsAVX2_();
+	case InstructionSet::AVX512: return GetKernelsAVX512_();
+	default: return nullptr;
+	}
+}
+
+const char* MyDFT::Kernels::ToString(const InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+	case InstructionSet::Scalar: return "Scalar";
+	case InstructionSet::SSE2: return "SSE2";
+	case InstructionSet::AVX2: return "AVX2";
+	case InstructionSet::AVX512: return "AVX512";
+	default: return "Unknown";
+	}
+}
+
+const MyDFT::Kernels::KernelTable* MyDFT::Kernels::GetKernelsScalar_()
+{
+	static constexpr KernelTable table = MakeKernelTable<ScalarV>(InstructionSet::Scalar);
+	return &table;
+}
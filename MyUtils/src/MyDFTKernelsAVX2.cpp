@@ -0,0 +1,66 @@
+#include "MyDFTKernels.h"
+
+// Needs AVX2 and FMA code generation, see the flags set on this file in CMakeLists.txt. Only ever called after DetectInstructionSet() checked the CPU supports both.
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)) && (defined(_MSC_VER) || (defined(__AVX2__) && defined(__FMA__)))
+
+#include <immintrin.h>
+
+#include "MyDFTKernelsImpl.h"
+
+namespace
+{
+	struct AVX2V
+	{
+		using Type = __m256;
+		using IType = __m256i;
+		static constexpr size_t WIDTH = 8;
+
+		static inline Type Load(const float* p) { return _mm256_loadu_ps(p); }
+		static inline void Store(float* p, const Type a) { _mm256_storeu_ps(p, a); }
+		static inline Type Set1(const float a) { return _mm256_set1_ps(a); }
+		static inline Type Zero() { return _mm256_setzero_ps(); }
+		static inline Type Add(const Type a, const Type b) { return _mm256_add_ps(a, b); }
+		static inline Type Sub(const Type a, const Type b) { return _mm256_sub_ps(a, b); }
+		static inline Type Mul(const Type a, const Type b) { return _mm256_mul_ps(a, b); }
+		static inline Type MulAdd(const Type a, const Type b, const Type c) { return _mm256_fmadd_ps(a, b, c); }
+		static inline Type NegMulAdd(const Type a, const Type b, const Type c) { return _mm256_fnmadd_ps(a, b, c); }
+
+		static inline IType ISet1(const int32_t a) { return _mm256_set1_epi32(a); }
+		static inline IType ILanes() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+		static inline IType IAdd(const IType a, const IType b) { return _mm256_add_epi32(a, b); }
+		static inline IType IWrap(const IType a, const IType n)
+		{
+			const IType tooSmall = _mm256_cmpgt_epi32(n, a); // All ones where a < n.
+			return _mm256_sub_epi32(a, _mm256_andnot_si256(tooSmall, n));
+		}
+		static inline Type Gather(const float* table, const IType i) { return _mm256_i32gather_ps(table, i, 4); }
+
+		static inline void Transpose4(const float* x, const size_t xStride, float* y, const size_t yStride)
+		{
+			__m128 r0 = _mm_loadu_ps(x + 0 * xStride);
+			__m128 r1 = _mm_loadu_ps(x + 1 * xStride);
+			__m128 r2 = _mm_loadu_ps(x + 2 * xStride);
+			__m128 r3 = _mm_loadu_ps(x + 3 * xStride);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			_mm_storeu_ps(y + 0 * yStride, r0);
+			_mm_storeu_ps(y + 1 * yStride, r1);
+			_mm_storeu_ps(y + 2 * yStride, r2);
+			_mm_storeu_ps(y + 3 * yStride, r3);
+		}
+	};
+}
+
+const MyDFT::Kernels::KernelTable* MyDFT::Kernels::GetKernelsAVX2_()
+{
+	static constexpr KernelTable table = MakeKernelTable<AVX2V>(InstructionSet::AVX2);
+	return &table;
+}
+
+#else
+
+const MyDFT::Kernels::KernelTable* MyDFT::Kernels::GetKernelsAVX2_()
+{
+	return nullptr;
+}
+
+#endif
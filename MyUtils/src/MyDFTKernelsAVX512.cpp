@@ -0,0 +1,66 @@
+#include "MyDFTKernels.h"
+
+// Needs AVX-512F code generation, see the flags set on this file in CMakeLists.txt. Only ever called after DetectInstructionSet() checked the CPU and the OS support it.
+#if (defined(_M_X64) || defined(__x86_64__)) && (defined(_MSC_VER) || defined(__AVX512F__))
+
+#include <immintrin.h>
+
+#include "MyDFTKernelsImpl.h"
+
+namespace
+{
+	struct AVX512V
+	{
+		using Type = __m512;
+		using IType = __m512i;
+		static constexpr size_t WIDTH = 16;
+
+		static inline Type Load(const float* p) { return _mm512_loadu_ps(p); }
+		static inline void Store(float* p, const Type a) { _mm512_storeu_ps(p, a); }
+		static inline Type Set1(const float a) { return _mm512_set1_ps(a); }
+		static inline Type Zero() { return _mm512_setzero_ps(); }
+		static inline Type Add(const Type a, const Type b) { return _mm512_add_ps(a, b); }
+		static inline Type Sub(const Type a, const Type b) { return _mm512_sub_ps(a, b); }
+		static inline Type Mul(const Type a, const Type b) { return _mm512_mul_ps(a, b); }
+		static inline Type MulAdd(const Type a, const Type b, const Type c) { return _mm512_fmadd_ps(a, b, c); }
+		static inline Type NegMulAdd(const Type a, const Type b, const Type c) { return _mm512_fnmadd_ps(a, b, c); }
+
+		static inline IType ISet1(const int32_t a) { return _mm512_set1_epi32(a); }
+		static inline IType ILanes() { return _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+		static inline IType IAdd(const IType a, const IType b) { return _mm512_add_epi32(a, b); }
+		static inline IType IWrap(const IType a, const IType n)
+		{
+			const __mmask16 notSmaller = _mm512_cmpge_epi32_mask(a, n);
+			return _mm512_mask_sub_epi32(a, notSmaller, a, n);
+		}
+		static inline Type Gather(const float* table, const IType i) { return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), (__mmask16)0xFFFF, i, table, 4); } // From zero, the unmasked gather starts from an undefined register.
+
+		static inline void Transpose4(const float* x, const size_t xStride, float* y, const size_t yStride)
+		{
+			__m128 r0 = _mm_loadu_ps(x + 0 * xStride);
+			__m128 r1 = _mm_loadu_ps(x + 1 * xStride);
+			__m128 r2 = _mm_loadu_ps(x + 2 * xStride);
+			__m128 r3 = _mm_loadu_ps(x + 3 * xStride);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			_mm_storeu_ps(y + 0 * yStride, r0);
+			_mm_storeu_ps(y + 1 * yStride, r1);
+			_mm_storeu_ps(y + 2 * yStride, r2);
+			_mm_storeu_ps(y + 3 * yStride, r3);
+		}
+	};
+}
+
+const MyDFT::Kernels::KernelTable* MyDFT::Kernels::GetKernelsAVX512_()
+{
+	static constexpr KernelTable table = MakeKernelTable<AVX512V>(InstructionSet::AVX512);
+	return &table;
+}
+
+#else
+
+const MyDFT::Kernels::KernelTable* MyDFT::Kernels::GetKernelsAVX512_()
+{
+	return nullptr;
+}
+
+#endif
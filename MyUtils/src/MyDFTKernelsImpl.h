@@ -0,0 +1,567 @@
+#pragma once
+
+// Bodies of the MyDFT kernels, written once against a vector type V and included by every MyDFTKernels*.cpp file, each compiled for a different instruction set.
+// Everything lives in an anonymous namespace on purpose: each translation unit must get its own copy, otherwise the linker could merge an AVX-512 instantiation into the scalar path.
+//
+// V must provide:
+//	Type, IType: float and int32 vectors of WIDTH lanes.
+//	Load(const float*), Store(float*, Type): unaligned loads and stores.
+//	Set1(float), Zero(): broadcasts.
+//	Add, Sub, Mul, MulAdd(a, b, c) = a*b+c, NegMulAdd(a, b, c) = c-a*b.
+//	ISet1(int), ILanes(): broadcast and {0, 1, ..., WIDTH-1}.
+//	IAdd, IWrap(i, n): integer add and (i >= n ? i - n : i).
+//	Gather(const float* table, IType i): table[i] for every lane.
+//	Transpose4(const float* x, size_t xStride, float* y, size_t yStride): y[c*yStride + r] = x[r*xStride + c] for r, c < 4.
+
+#include "MyDFTKernels.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// The butterflies must be inlined into the loops for the vector types and the loop indices to stay in registers. Compilers give up on their own with this many instantiations.
+#if defined(_MSC_VER)
+#define MYDFT_FORCEINLINE __forceinline
+#else
+#define MYDFT_FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+namespace
+{
+	// Width 1 vector type, used for the leftovers of the vectorized loops and as the whole scalar path.
+	struct ScalarV
+	{
+		using Type = float;
+		using IType = int32_t;
+		static constexpr size_t WIDTH = 1;
+
+		static inline Type Load(const float* p) { return *p; }
+		static inline void Store(float* p, const Type a) { *p = a; }
+		static inline Type Set1(const float a) { return a; }
+		static inline Type Zero() { return 0.0f; }
+		static inline Type Add(const Type a, const Type b) { return a + b; }
+		static inline Type Sub(const Type a, const Type b) { return a - b; }
+		static inline Type Mul(const Type a, const Type b) { return a * b; }
+		static inline Type MulAdd(const Type a, const Type b, const Type c) { return a * b + c; }
+		static inline Type NegMulAdd(const Type a, const Type b, const Type c) { return c - a * b; }
+
+		static inline IType ISet1(const int32_t a) { return a; }
+		static inline IType ILanes() { return 0; }
+		static inline IType IAdd(const IType a, const IType b) { return a + b; }
+		static inline IType IWrap(const IType a, const IType n) { return (a >= n) ? a - n : a; }
+		static inline Type Gather(const float* table, const IType i) { return table[i]; }
+
+		static inline void Transpose4(const float* x, const size_t xStride, float* y, const size_t yStride)
+		{
+			for (size_t r = 0; r < 4; ++r)
+			{
+				for (size_t c = 0; c < 4; ++c)
+				{
+					y[c * yStride + r] = x[r * xStride + c];
+				}
+			}
+		}
+	};
+
+	// Complex value stored as separate real and imaginary vectors.
+	template<class V>
+	struct SplitComplex
+	{
+		typename V::Type re;
+		typename V::Type im;
+	};
+
+	template<class V>
+	MYDFT_FORCEINLINE SplitComplex<V> LoadC(const float* re, const float* im, const size_t i)
+	{
+		return { V::Load(re + i), V::Load(im + i) };
+	}
+
+	template<class V>
+	MYDFT_FORCEINLINE void StoreC(float* re, float* im, const size_t i, const SplitComplex<V> a)
+	{
+		V::Store(re + i, a.re);
+		V::Store(im + i, a.im);
+	}
+
+	template<class V>
+	MYDFT_FORCEINLINE SplitComplex<V> AddC(const SplitComplex<V> a, const SplitComplex<V> b)
+	{
+		return { V::Add(a.re, b.re), V::Add(a.im, b.im) };
+	}
+
+	template<class V>
+	MYDFT_FORCEINLINE SplitComplex<V> SubC(const SplitComplex<V> a, const SplitComplex<V> b)
+	{
+		return { V::Sub(a.re, b.re), V::Sub(a.im, b.im) };
+	}
+
+	template<class V>
+	MYDFT_FORCEINLINE SplitComplex<V> MulC(const SplitComplex<V> a, const SplitComplex<V> b)
+	{
+		return { V::NegMulAdd(a.im, b.im, V::Mul(a.re, b.re)), V::MulAdd(a.im, b.re, V::Mul(a.re, b.im)) };
+	}
+
+	// a * i * c for a real c, the multiplication by a root of unity on the imaginary axis.
+	template<class V>
+	MYDFT_FORCEINLINE SplitComplex<V> MulIC(const SplitComplex<V> a, const typename V::Type c)
+	{
+		return { V::Sub(V::Zero(), V::Mul(a.im, c)), V::Mul(a.re, c) };
+	}
+
+	// Where a butterfly reads and writes: a_r = x[in + r*inStride] and y[out + t*outStride] for r, t < radix.
+	struct Butterfly
+	{
+		size_t in;
+		size_t inStride;
+		size_t out;
+		size_t outStride;
+		size_t j; // Index of the butterfly's twiddles.
+	};
+
+	// Twiddle w[j][t], broadcast to all lanes when vectorizing over q, loaded for WIDTH consecutive j's when vectorizing over j.
+	template<class V, bool VECTOR_J>
+	MYDFT_FORCEINLINE SplitComplex<V> Twiddle(const MyDFT::Kernels::StageArgs& a, const size_t t, const size_t j)
+	{
+		const size_t i = (t - 1) * a.m + j;
+		if constexpr (VECTOR_J) return { V::Load(a.twr + i), V::Load(a.twi + i) };
+		else return { V::Set1(a.twr[i]), V::Set1(a.twi[i]) };
+	}
+
+	// Runs Body on every butterfly of a stage, WIDTH butterflies at a time along the contiguous index (q, or j for transposed stages), then the leftovers with ScalarV.
+	template<class V, template<class, bool, bool> class Body, bool INVERSE>
+	MYDFT_FORCEINLINE void ForEachButterfly(const MyDFT::Kernels::StageArgs& a)
+	{
+		const size_t p = Body<ScalarV, INVERSE, false>::RADIX;
+		const size_t s = a.s;
+		const size_t m = a.m;
+
+		if (!a.transposed)
+		{
+			// a_r = x[q + s*(j + r*m)], y[q + s*(p*j + t)]
+			for (size_t j = a.jBegin; j < a.jEnd; ++j)
+			{
+				size_t q = a.qBegin;
+				if constexpr (V::WIDTH > 1)
+				{
+					for (; q + V::WIDTH <= a.qEnd; q += V::WIDTH)
+					{
+						Body<V, INVERSE, false>::Run(a, { q + s * j, s * m, q + s * p * j, s, j });
+					}
+				}
+				for (; q < a.qEnd; ++q)
+				{
+					Body<ScalarV, INVERSE, false>::Run(a, { q + s * j, s * m, q + s * p * j, s, j });
+				}
+			}
+			return;
+		}
+
+		// a_r = x[j + m*(r + p*q)], y[j + m*(q + s*t)]
+		for (size_t q = a.qBegin; q < a.qEnd; ++q)
+		{
+			size_t j = a.jBegin;
+			if constexpr (V::WIDTH > 1)
+			{
+				for (; j + V::WIDTH <= a.jEnd; j += V::WIDTH)
+				{
+					Body<V, INVERSE, true>::Run(a, { j + p * m * q, m, j + m * q, m * s, j });
+				}
+			}
+			for (; j < a.jEnd; ++j)
+			{
+				Body<ScalarV, INVERSE, false>::Run(a, { j + p * m * q, m, j + m * q, m * s, j });
+			}
+		}
+	}
+
+	template<class V, template<class, bool, bool> class Body>
+	void RunStage(const MyDFT::Kernels::StageArgs& a)
+	{
+		if (a.inverse) ForEachButterfly<V, Body, true>(a);
+		else ForEachButterfly<V, Body, false>(a);
+	}
+
+	template<class V, bool INVERSE, bool VECTOR_J>
+	struct Radix2
+	{
+		static constexpr size_t RADIX = 2;
+
+		static MYDFT_FORCEINLINE void Run(const MyDFT::Kernels::StageArgs& a, const Butterfly b)
+		{
+			const SplitComplex<V> a0 = LoadC<V>(a.xr, a.xi, b.in);
+			const SplitComplex<V> a1 = LoadC<V>(a.xr, a.xi, b.in + b.inStride);
+			StoreC<V>(a.yr, a.yi, b.out, AddC<V>(a0, a1));
+			StoreC<V>(a.yr, a.yi, b.out + b.outStride, MulC<V>(SubC<V>(a0, a1), Twiddle<V, VECTOR_J>(a, 1, b.j)));
+		}
+	};
+
+	template<class V, bool INVERSE, bool VECTOR_J>
+	struct Radix4
+	{
+		static constexpr size_t RADIX = 4;
+
+		static MYDFT_FORCEINLINE void Run(const MyDFT::Kernels::StageArgs& a, const Butterfly b)
+		{
+			const typename V::Type rotation = V::Set1(INVERSE ? 1.0f : -1.0f); // Sign of the imaginary unit in w_4 = e^(-+i*PI/2).
+			const SplitComplex<V> a0 = LoadC<V>(a.xr, a.xi, b.in + 0 * b.inStride);
+			const SplitComplex<V> a1 = LoadC<V>(a.xr, a.xi, b.in + 1 * b.inStride);
+			const SplitComplex<V> a2 = LoadC<V>(a.xr, a.xi, b.in + 2 * b.inStride);
+			const SplitComplex<V> a3 = LoadC<V>(a.xr, a.xi, b.in + 3 * b.inStride);
+			const SplitComplex<V> t0 = AddC<V>(a0, a2);
+			const SplitComplex<V> t1 = SubC<V>(a0, a2);
+			const SplitComplex<V> t2 = AddC<V>(a1, a3);
+			const SplitComplex<V> t3 = MulIC<V>(SubC<V>(a1, a3), rotation); // (a1 - a3) * w_4.
+			StoreC<V>(a.yr, a.yi, b.out + 0 * b.outStride, AddC<V>(t0, t2));
+			StoreC<V>(a.yr, a.yi, b.out + 1 * b.outStride, MulC<V>(AddC<V>(t1, t3), Twiddle<V, VECTOR_J>(a, 1, b.j)));
+			StoreC<V>(a.yr, a.yi, b.out + 2 * b.outStride, MulC<V>(SubC<V>(t0, t2), Twiddle<V, VECTOR_J>(a, 2, b.j)));
+			StoreC<V>(a.yr, a.yi, b.out + 3 * b.outStride, MulC<V>(SubC<V>(t1, t3), Twiddle<V, VECTOR_J>(a, 3, b.j)));
+		}
+	};
+
+	template<class V, bool INVERSE, bool VECTOR_J>
+	struct Radix3
+	{
+		static constexpr size_t RADIX = 3;
+
+		static MYDFT_FORCEINLINE void Run(const MyDFT::Kernels::StageArgs& a, const Butterfly b)
+		{
+			const typename V::Type sin60 = V::Set1(INVERSE ? 0.86602540378f : -0.86602540378f);
+			const typename V::Type half = V::Set1(0.5f);
+			const SplitComplex<V> a0 = LoadC<V>(a.xr, a.xi, b.in + 0 * b.inStride);
+			const SplitComplex<V> a1 = LoadC<V>(a.xr, a.xi, b.in + 1 * b.inStride);
+			const SplitComplex<V> a2 = LoadC<V>(a.xr, a.xi, b.in + 2 * b.inStride);
+			const SplitComplex<V> t1 = AddC<V>(a1, a2);
+			const SplitComplex<V> t2 = { V::NegMulAdd(half, t1.re, a0.re), V::NegMulAdd(half, t1.im, a0.im) }; // a0 - t1 / 2.
+			const SplitComplex<V> t3 = MulIC<V>(SubC<V>(a1, a2), sin60); // i * sin(60) * (a1 - a2).
+			StoreC<V>(a.yr, a.yi, b.out + 0 * b.outStride, AddC<V>(a0, t1));
+			StoreC<V>(a.yr, a.yi, b.out + 1 * b.outStride, MulC<V>(AddC<V>(t2, t3), Twiddle<V, VECTOR_J>(a, 1, b.j)));
+			StoreC<V>(a.yr, a.yi, b.out + 2 * b.outStride, MulC<V>(SubC<V>(t2, t3), Twiddle<V, VECTOR_J>(a, 2, b.j)));
+		}
+	};
+
+	template<class V, bool INVERSE, bool VECTOR_J>
+	struct Radix5
+	{
+		static constexpr size_t RADIX = 5;
+
+		static MYDFT_FORCEINLINE void Run(const MyDFT::Kernels::StageArgs& a, const Butterfly b)
+		{
+			const typename V::Type c1 = V::Set1(0.30901699437f); // cos(2*PI/5)
+			const typename V::Type c2 = V::Set1(-0.80901699437f); // cos(4*PI/5)
+			const typename V::Type s1 = V::Set1(INVERSE ? 0.95105651629f : -0.95105651629f); // sin(2*PI/5)
+			const typename V::Type s2 = V::Set1(INVERSE ? 0.58778525229f : -0.58778525229f); // sin(4*PI/5)
+			const typename V::Type one = V::Set1(1.0f);
+			const SplitComplex<V> a0 = LoadC<V>(a.xr, a.xi, b.in + 0 * b.inStride);
+			const SplitComplex<V> a1 = LoadC<V>(a.xr, a.xi, b.in + 1 * b.inStride);
+			const SplitComplex<V> a2 = LoadC<V>(a.xr, a.xi, b.in + 2 * b.inStride);
+			const SplitComplex<V> a3 = LoadC<V>(a.xr, a.xi, b.in + 3 * b.inStride);
+			const SplitComplex<V> a4 = LoadC<V>(a.xr, a.xi, b.in + 4 * b.inStride);
+			const SplitComplex<V> t1 = AddC<V>(a1, a4);
+			const SplitComplex<V> t2 = AddC<V>(a2, a3);
+			const SplitComplex<V> t3 = SubC<V>(a1, a4);
+			const SplitComplex<V> t4 = SubC<V>(a2, a3);
+			const SplitComplex<V> r1 = { V::MulAdd(c2, t2.re, V::MulAdd(c1, t1.re, a0.re)), V::MulAdd(c2, t2.im, V::MulAdd(c1, t1.im, a0.im)) }; // a0 + c1 * t1 + c2 * t2.
+			const SplitComplex<V> r2 = { V::MulAdd(c1, t2.re, V::MulAdd(c2, t1.re, a0.re)), V::MulAdd(c1, t2.im, V::MulAdd(c2, t1.im, a0.im)) }; // a0 + c2 * t1 + c1 * t2.
+			const SplitComplex<V> i1 = { V::MulAdd(s2, t4.re, V::Mul(s1, t3.re)), V::MulAdd(s2, t4.im, V::Mul(s1, t3.im)) }; // s1 * t3 + s2 * t4.
+			const SplitComplex<V> i2 = { V::NegMulAdd(s1, t4.re, V::Mul(s2, t3.re)), V::NegMulAdd(s1, t4.im, V::Mul(s2, t3.im)) }; // s2 * t3 - s1 * t4.
+			const SplitComplex<V> j1 = MulIC<V>(i1, one);
+			const SplitComplex<V> j2 = MulIC<V>(i2, one);
+			StoreC<V>(a.yr, a.yi, b.out + 0 * b.outStride, AddC<V>(a0, AddC<V>(t1, t2)));
+			StoreC<V>(a.yr, a.yi, b.out + 1 * b.outStride, MulC<V>(AddC<V>(r1, j1), Twiddle<V, VECTOR_J>(a, 1, b.j)));
+			StoreC<V>(a.yr, a.yi, b.out + 2 * b.outStride, MulC<V>(AddC<V>(r2, j2), Twiddle<V, VECTOR_J>(a, 2, b.j)));
+			StoreC<V>(a.yr, a.yi, b.out + 3 * b.outStride, MulC<V>(SubC<V>(r2, j2), Twiddle<V, VECTOR_J>(a, 3, b.j)));
+			StoreC<V>(a.yr, a.yi, b.out + 4 * b.outStride, MulC<V>(SubC<V>(r1, j1), Twiddle<V, VECTOR_J>(a, 4, b.j)));
+		}
+	};
+
+	// y[c*yStride + r] = x[r*xStride + c], in 4x4 tiles grouped in blocks that fit in cache.
+	template<class V>
+	void Transpose(const float* x, const size_t xStride, float* y, const size_t yStride, const size_t rows, const size_t cols)
+	{
+		constexpr size_t BLOCK = 32;
+		const size_t rows4 = rows - rows % 4;
+		const size_t cols4 = cols - cols % 4;
+		for (size_t r0 = 0; r0 < rows4; r0 += BLOCK)
+		{
+			const size_t r1 = (r0 + BLOCK < rows4) ? r0 + BLOCK : rows4;
+			for (size_t c0 = 0; c0 < cols4; c0 += BLOCK)
+			{
+				const size_t c1 = (c0 + BLOCK < cols4) ? c0 + BLOCK : cols4;
+				for (size_t r = r0; r < r1; r += 4)
+				{
+					for (size_t c = c0; c < c1; c += 4)
+					{
+						V::Transpose4(x + r * xStride + c, xStride, y + c * yStride + r, yStride);
+					}
+				}
+			}
+		}
+
+		// Leftover rows and columns when the sizes aren't multiples of 4.
+		for (size_t r = 0; r < rows; ++r)
+		{
+			for (size_t c = (r < rows4) ? cols4 : 0; c < cols; ++c)
+			{
+				y[c * yStride + r] = x[r * xStride + c];
+			}
+		}
+	}
+
+	// Direct accumulation for outputs [o, o + WIDTH): every lane walks the exponential table with its own step o % N.
+	template<class V, bool COMPLEX_INPUT>
+	MYDFT_FORCEINLINE void DirectBlock(const MyDFT::Kernels::DirectArgs& a, const size_t o)
+	{
+		const typename V::IType n = V::ISet1((int32_t)a.N);
+		const typename V::IType step = V::IWrap(V::IAdd(V::ISet1((int32_t)(o % a.N)), V::ILanes()), n);
+		const typename V::Type sign = V::Set1(a.sign);
+		typename V::IType index = V::ISet1(0);
+		typename V::Type accRe = V::Zero();
+		typename V::Type accIm = V::Zero();
+
+		for (size_t i = 0; i < a.count; ++i)
+		{
+			const typename V::Type c = V::Gather(a.cosTable, index);
+			const typename V::Type s = V::Mul(sign, V::Gather(a.sinTable, index));
+			const typename V::Type inRe = V::Set1(a.inRe[i]);
+			// (inRe + i*inIm) * (c + i*s)
+			accRe = V::MulAdd(inRe, c, accRe);
+			accIm = V::MulAdd(inRe, s, accIm);
+			if constexpr (COMPLEX_INPUT)
+			{
+				const typename V::Type inIm = V::Set1(a.inIm[i]);
+				accRe = V::NegMulAdd(inIm, s, accRe);
+				accIm = V::MulAdd(inIm, c, accIm);
+			}
+			index = V::IWrap(V::IAdd(index, step), n);
+		}
+
+		V::Store(a.outRe + (o - a.outBegin), accRe);
+		if (a.outIm) V::Store(a.outIm + (o - a.outBegin), accIm);
+	}
+
+	template<class V, bool COMPLEX_INPUT>
+	inline void DirectAll(const MyDFT::Kernels::DirectArgs& a)
+	{
+		// Lane steps only stay below N if o % N + WIDTH - 1 wraps at most once, which holds as long as WIDTH <= N.
+		size_t o = a.outBegin;
+		if constexpr (V::WIDTH > 1)
+		{
+			if (a.N >= V::WIDTH)
+			{
+				for (; o + V::WIDTH <= a.outEnd; o += V::WIDTH)
+				{
+					DirectBlock<V, COMPLEX_INPUT>(a, o);
+				}
+			}
+		}
+		for (; o < a.outEnd; ++o)
+		{
+			DirectBlock<ScalarV, COMPLEX_INPUT>(a, o);
+		}
+	}
+
+	template<class V>
+	void Direct(const MyDFT::Kernels::DirectArgs& a)
+	{
+		if (a.inIm) DirectAll<V, true>(a);
+		else DirectAll<V, false>(a);
+	}
+
+	// acc[i] += a[i] * b[i] on split complex arrays, the spectral product of fast convolutions.
+	template<class V>
+	void MultiplyAccumulate(const float* aRe, const float* aIm, const float* bRe, const float* bIm, float* accRe, float* accIm, const size_t count)
+	{
+		size_t i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+		{
+			const SplitComplex<V> a = LoadC<V>(aRe, aIm, i);
+			const SplitComplex<V> b = LoadC<V>(bRe, bIm, i);
+			const SplitComplex<V> acc = LoadC<V>(accRe, accIm, i);
+			StoreC<V>(accRe, accIm, i, { V::NegMulAdd(a.im, b.im, V::MulAdd(a.re, b.re, acc.re)), V::MulAdd(a.im, b.re, V::MulAdd(a.re, b.im, acc.im)) });
+		}
+		for (; i < count; ++i)
+		{
+			accRe[i] += aRe[i] * bRe[i] - aIm[i] * bIm[i];
+			accIm[i] += aRe[i] * bIm[i] + aIm[i] * bRe[i];
+		}
+	}
+
+	// Goertzel recurrence s[n] = x[n] + c * s[n-1] - s[n-2] for lanes [b, b + BLOCKS*WIDTH). Every lane reads the same samples, or its own ones if stride isn't 0.
+	// The recurrence is a dependency chain, running BLOCKS vectors side by side hides its latency.
+	template<class V, size_t BLOCKS>
+	MYDFT_FORCEINLINE void GoertzelBlock(const float* x, const size_t stride, const size_t count, const float* coefficients, float* s1, float* s2, const size_t b)
+	{
+		typename V::Type c[BLOCKS], prev[BLOCKS], prev2[BLOCKS];
+		for (size_t v = 0; v < BLOCKS; ++v)
+		{
+			c[v] = V::Load(coefficients + b + v * V::WIDTH);
+			prev[v] = V::Load(s1 + b + v * V::WIDTH);
+			prev2[v] = V::Load(s2 + b + v * V::WIDTH);
+		}
+		if (stride)
+		{
+			for (size_t n = 0; n < count; ++n)
+			{
+				for (size_t v = 0; v < BLOCKS; ++v)
+				{
+					const typename V::Type current = V::Sub(V::MulAdd(c[v], prev[v], V::Load(x + n * stride + b + v * V::WIDTH)), prev2[v]);
+					prev2[v] = prev[v];
+					prev[v] = current;
+				}
+			}
+		}
+		else
+		{
+			for (size_t n = 0; n < count; ++n)
+			{
+				const typename V::Type sample = V::Set1(x[n]);
+				for (size_t v = 0; v < BLOCKS; ++v)
+				{
+					const typename V::Type current = V::Sub(V::MulAdd(c[v], prev[v], sample), prev2[v]);
+					prev2[v] = prev[v];
+					prev[v] = current;
+				}
+			}
+		}
+		for (size_t v = 0; v < BLOCKS; ++v)
+		{
+			V::Store(s1 + b + v * V::WIDTH, prev[v]);
+			V::Store(s2 + b + v * V::WIDTH, prev2[v]);
+		}
+	}
+
+	template<class V>
+	void Goertzel(const float* x, const size_t stride, const size_t count, const float* coefficients, float* s1, float* s2, const size_t lanes)
+	{
+		size_t b = 0;
+		for (; b + 4 * V::WIDTH <= lanes; b += 4 * V::WIDTH)
+		{
+			GoertzelBlock<V, 4>(x, stride, count, coefficients, s1, s2, b);
+		}
+		for (; b + V::WIDTH <= lanes; b += V::WIDTH)
+		{
+			GoertzelBlock<V, 1>(x, stride, count, coefficients, s1, s2, b);
+		}
+		for (; b < lanes; ++b)
+		{
+			GoertzelBlock<ScalarV, 1>(x, stride, count, coefficients, s1, s2, b);
+		}
+	}
+
+	// Sliding DFT update bin = twiddle * (bin + delta[n]) for lanes [b, b + BLOCKS*WIDTH), interleaving BLOCKS vectors like GoertzelBlock().
+	template<class V, size_t BLOCKS>
+	MYDFT_FORCEINLINE void SlideBlock(const float* deltas, const size_t count, const float* twiddlesRe, const float* twiddlesIm, float* binsRe, float* binsIm, const size_t b)
+	{
+		typename V::Type tRe[BLOCKS], tIm[BLOCKS], re[BLOCKS], im[BLOCKS];
+		for (size_t v = 0; v < BLOCKS; ++v)
+		{
+			tRe[v] = V::Load(twiddlesRe + b + v * V::WIDTH);
+			tIm[v] = V::Load(twiddlesIm + b + v * V::WIDTH);
+			re[v] = V::Load(binsRe + b + v * V::WIDTH);
+			im[v] = V::Load(binsIm + b + v * V::WIDTH);
+		}
+		for (size_t n = 0; n < count; ++n)
+		{
+			const typename V::Type delta = V::Set1(deltas[n]);
+			for (size_t v = 0; v < BLOCKS; ++v)
+			{
+				const typename V::Type shifted = V::Add(re[v], delta);
+				re[v] = V::NegMulAdd(im[v], tIm[v], V::Mul(shifted, tRe[v]));
+				im[v] = V::MulAdd(shifted, tIm[v], V::Mul(im[v], tRe[v]));
+			}
+		}
+		for (size_t v = 0; v < BLOCKS; ++v)
+		{
+			V::Store(binsRe + b + v * V::WIDTH, re[v]);
+			V::Store(binsIm + b + v * V::WIDTH, im[v]);
+		}
+	}
+
+	template<class V>
+	void Slide(const float* deltas, const size_t count, const float* twiddlesRe, const float* twiddlesIm, float* binsRe, float* binsIm, const size_t bins)
+	{
+		size_t b = 0;
+		for (; b + 4 * V::WIDTH <= bins; b += 4 * V::WIDTH)
+		{
+			SlideBlock<V, 4>(deltas, count, twiddlesRe, twiddlesIm, binsRe, binsIm, b);
+		}
+		for (; b + V::WIDTH <= bins; b += V::WIDTH)
+		{
+			SlideBlock<V, 1>(deltas, count, twiddlesRe, twiddlesIm, binsRe, binsIm, b);
+		}
+		for (; b < bins; ++b)
+		{
+			SlideBlock<ScalarV, 1>(deltas, count, twiddlesRe, twiddlesIm, binsRe, binsIm, b);
+		}
+	}
+
+	// Adds Re(p) of partial j to out, rotating its OSCILLATOR_VECTORS vectors of phasors side by side. They are independent dependency chains, which hides the latency of the rotations even with a single partial.
+	template<class V>
+	MYDFT_FORCEINLINE void OscillatePartial(float* out, const size_t count, const float* phasorsRe, const float* phasorsIm, const float stepRe, const float stepIm)
+	{
+		constexpr size_t VECTORS = MyDFT::Kernels::OSCILLATOR_VECTORS;
+		typename V::Type pRe[VECTORS], pIm[VECTORS];
+		for (size_t v = 0; v < VECTORS; ++v)
+		{
+			pRe[v] = V::Load(phasorsRe + v * V::WIDTH);
+			pIm[v] = V::Load(phasorsIm + v * V::WIDTH);
+		}
+		const typename V::Type sRe = V::Set1(stepRe);
+		const typename V::Type sIm = V::Set1(stepIm);
+		size_t n = 0;
+		for (; n + VECTORS * V::WIDTH <= count; n += VECTORS * V::WIDTH)
+		{
+			for (size_t v = 0; v < VECTORS; ++v)
+			{
+				V::Store(out + n + v * V::WIDTH, V::Add(V::Load(out + n + v * V::WIDTH), pRe[v]));
+				const typename V::Type re = pRe[v];
+				pRe[v] = V::NegMulAdd(pIm[v], sIm, V::Mul(re, sRe));
+				pIm[v] = V::MulAdd(re, sIm, V::Mul(pIm[v], sRe));
+			}
+		}
+
+		// Leftovers, less than VECTORS vectors: the phasors of the next vectors are ready, whole vectors first, then the lanes of the last partial one.
+		size_t v = 0;
+		for (; v < VECTORS && n + V::WIDTH <= count; ++v, n += V::WIDTH)
+		{
+			V::Store(out + n, V::Add(V::Load(out + n), pRe[v]));
+		}
+		if (n == count) return;
+		float lanes[V::WIDTH];
+		V::Store(lanes, pRe[v]);
+		for (size_t l = 0; n + l < count; ++l)
+		{
+			out[n + l] += lanes[l];
+		}
+	}
+
+	template<class V>
+	void Oscillate(float* out, const size_t count, const float* phasorsRe, const float* phasorsIm, const float* stepsRe, const float* stepsIm, const size_t partials)
+	{
+		constexpr size_t LANES = MyDFT::Kernels::OSCILLATOR_VECTORS * V::WIDTH;
+		for (size_t j = 0; j < partials; ++j)
+		{
+			OscillatePartial<V>(out, count, phasorsRe + j * LANES, phasorsIm + j * LANES, stepsRe[j], stepsIm[j]);
+		}
+	}
+
+	// Kernel table of vector type V. constexpr so that the tables are constant-initialized: no code compiled for an unsupported instruction set runs before the CPU was checked.
+	template<class V>
+	constexpr MyDFT::Kernels::KernelTable MakeKernelTable(const MyDFT::Kernels::InstructionSet instructionSet)
+	{
+		MyDFT::Kernels::KernelTable table;
+		table.instructionSet = instructionSet;
+		table.width = (unsigned int)V::WIDTH;
+		table.radix2 = &RunStage<V, Radix2>;
+		table.radix3 = &RunStage<V, Radix3>;
+		table.radix4 = &RunStage<V, Radix4>;
+		table.radix5 = &RunStage<V, Radix5>;
+		table.direct = &Direct<V>;
+		table.transpose = &Transpose<V>;
+		table.multiplyAccumulate = &MultiplyAccumulate<V>;
+		table.goertzel = &Goertzel<V>;
+		table.slide = &Slide<V>;
+		table.oscillate = &Oscillate<V>;
+		return table;
+	}
+}
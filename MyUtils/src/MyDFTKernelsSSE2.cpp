@@ -0,0 +1,71 @@
+#include "MyDFTKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+#include <emmintrin.h>
+
+#include "MyDFTKernelsImpl.h"
+
+namespace
+{
+	struct SSE2V
+	{
+		using Type = __m128;
+		using IType = __m128i;
+		static constexpr size_t WIDTH = 4;
+
+		static inline Type Load(const float* p) { return _mm_loadu_ps(p); }
+		static inline void Store(float* p, const Type a) { _mm_storeu_ps(p, a); }
+		static inline Type Set1(const float a) { return _mm_set1_ps(a); }
+		static inline Type Zero() { return _mm_setzero_ps(); }
+		static inline Type Add(const Type a, const Type b) { return _mm_add_ps(a, b); }
+		static inline Type Sub(const Type a, const Type b) { return _mm_sub_ps(a, b); }
+		static inline Type Mul(const Type a, const Type b) { return _mm_mul_ps(a, b); }
+		static inline Type MulAdd(const Type a, const Type b, const Type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static inline Type NegMulAdd(const Type a, const Type b, const Type c) { return _mm_sub_ps(c, _mm_mul_ps(a, b)); }
+
+		static inline IType ISet1(const int32_t a) { return _mm_set1_epi32(a); }
+		static inline IType ILanes() { return _mm_setr_epi32(0, 1, 2, 3); }
+		static inline IType IAdd(const IType a, const IType b) { return _mm_add_epi32(a, b); }
+		static inline IType IWrap(const IType a, const IType n)
+		{
+			const IType tooLarge = _mm_cmpgt_epi32(n, a); // All ones where a < n.
+			return _mm_sub_epi32(a, _mm_andnot_si128(tooLarge, n));
+		}
+		static inline Type Gather(const float* table, const IType i)
+		{
+			// No gather instruction before AVX2.
+			alignas(16) int32_t indices[4];
+			_mm_store_si128((IType*)indices, i);
+			return _mm_setr_ps(table[indices[0]], table[indices[1]], table[indices[2]], table[indices[3]]);
+		}
+
+		static inline void Transpose4(const float* x, const size_t xStride, float* y, const size_t yStride)
+		{
+			__m128 r0 = _mm_loadu_ps(x + 0 * xStride);
+			__m128 r1 = _mm_loadu_ps(x + 1 * xStride);
+			__m128 r2 = _mm_loadu_ps(x + 2 * xStride);
+			__m128 r3 = _mm_loadu_ps(x + 3 * xStride);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			_mm_storeu_ps(y + 0 * yStride, r0);
+			_mm_storeu_ps(y + 1 * yStride, r1);
+			_mm_storeu_ps(y + 2 * yStride, r2);
+			_mm_storeu_ps(y + 3 * yStride, r3);
+		}
+	};
+}
+
+const MyDFT::Kernels::KernelTable* MyDFT::Kernels::GetKernelsSSE2_()
+{
+	static constexpr KernelTable table = MakeKernelTable<SSE2V>(InstructionSet::SSE2);
+	return &table;
+}
+
+#else
+
+const MyDFT::Kernels::KernelTable* MyDFT::Kernels::GetKernelsSSE2_()
+{
+	return nullptr;
+}
+
+#endif
@@ -0,0 +1,433 @@
+#include "MyDFTPlan.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include "MyMath.h"
+
+// Plans of the calling thread, see GetPlan(). One cache per thread: Plans own scratch buffers so they can't be shared between threads anyways.
+static thread_local std::vector<std::shared_ptr<MyDFT::Plan>> cachedPlans_;
+
+// State of the Plans of a length and direction, whatever their number of bins.
+struct MyDFT::Plan::Shared_
+{
+	Shared_(const unsigned int N, const Direction direction): realEngine(N % 2 == 0 ? N / 2 : N, direction)
+	{
+		assert(N > 0 && "Cannot plan an empty transform.");
+		if (N % 2 != 0) return;
+
+		const double sign = (direction == Direction::Inverse) ? 1.0 : -1.0;
+		realTwiddles.resize(N / 2 + 1);
+		for (unsigned int k = 0; k <= N / 2; ++k)
+		{
+			const double angle = sign * 2.0 * MyMath::PI_D * (double)k / (double)N;
+			realTwiddles[k] = std::complex<float>((float)std::cos(angle), (float)std::sin(angle));
+		}
+	}
+
+	FFTEngine realEngine; // N/2-point engine for an even N, N-point engine for an odd N.
+	std::unique_ptr<FFTEngine> complexEngine; // N-point engine used by ExecuteComplex() for an even N.
+	std::vector<std::complex<float>> realTwiddles; // e^(-+i*2*PI*k/N) for k <= N/2, used to split the packed even / odd samples. Only for an even N.
+	std::vector<float> cosTable; // cos(2*PI*n/N) for n < N. Built by the first direct Plan.
+	std::vector<float> sinTable; // sin(2*PI*n/N) for n < N. Idem.
+};
+
+MyDFT::Plan::Plan(const unsigned int N, const unsigned int K, const Direction direction):
+	Plan(std::make_shared<Shared_>(N, direction), N, K, direction) {}
+
+MyDFT::Plan::Plan(const Plan& sameLength, const unsigned int K): Plan(sameLength.shared_, sameLength.N, K, sameLength.direction) {}
+
+MyDFT::Plan::Plan(std::shared_ptr<Shared_> shared, const unsigned int N, const unsigned int K, const Direction direction):
+	N(N), K(K), direction(direction), shared_(std::move(shared))
+{
+	workRe_.resize(shared_->realEngine.length);
+	workIm_.resize(shared_->realEngine.length);
+	half_.resize(N / 2 + 1);
+
+	// A direct sum costs N*K multiply-adds, the FFT about N*FFTEngine::CostPerValue(N)/2 once an even N is packed in half the points. An odd N runs the full N-point FFT.
+	direct_ = (N % 2 == 0 ? 2 : 1) * (size_t)K < FFTEngine::CostPerValue(N);
+	if (direct_)
+	{
+		if (shared_->cosTable.empty())
+		{
+			shared_->cosTable.resize(N);
+			shared_->sinTable.resize(N);
+			for (unsigned int n = 0; n < N; ++n)
+			{
+				const double angle = 2.0 * MyMath::PI_D * (double)n / (double)N;
+				shared_->cosTable[n] = (float)std::cos(angle);
+				shared_->sinTable[n] = (float)std::sin(angle);
+			}
+		}
+		directRe_.resize(std::max(N, K));
+		directIm_.resize(std::max(N, K));
+	}
+}
+
+void MyDFT::Plan::Execute(std::vector<std::complex<float>>& out, const std::vector<float>& x, MyUtils::ThreadPool* pool)
+{
+	assert(direction == Direction::Forward && "Executing a real-to-complex transform on an inverse plan.");
+	assert(x.size() == N && out.size() >= K && "Mismatching buffer sizes.");
+
+	if (direct_)
+	{
+		ExecuteDirect_(directRe_.data(), directIm_.data(), x.data(), nullptr, N, K, pool);
+		for (unsigned int k = 0; k < K; ++k)
+		{
+			out[k] = std::complex<float>(directRe_[k], directIm_[k]);
+		}
+		return;
+	}
+
+	ForwardHalf_(x.data(), pool);
+	SpreadBins_(out.data());
+}
+
+void MyDFT::Plan::Execute(std::vector<float>& out, const std::vector<std::complex<float>>& y, MyUtils::ThreadPool* pool)
+{
+	assert(direction == Direction::Inverse && "Executing a complex-to-real transform on a forward plan.");
+	assert(y.size() == K && out.size() >= N && "Mismatching buffer sizes.");
+
+	if (direct_)
+	{
+		for (unsigned int k = 0; k < K; ++k)
+		{
+			directRe_[k] = y[k].real();
+			directIm_[k] = y[k].imag();
+		}
+		ExecuteDirect_(out.data(), nullptr, directRe_.data(), directIm_.data(), K, N, pool);
+		const float scale = 1.0f / (float)N;
+		for (unsigned int n = 0; n < N; ++n)
+		{
+			out[n] *= scale;
+		}
+		return;
+	}
+
+	FoldBins_(y.data());
+	InverseHalf_(out.data(), pool);
+}
+
+void MyDFT::Plan::ExecuteHermitian(std::vector<float>& out, const std::vector<std::complex<float>>& y, MyUtils::ThreadPool* pool)
+{
+	assert(direction == Direction::Inverse && "Executing a complex-to-real transform on a forward plan.");
+	assert(y.size() == N / 2 + 1 && out.size() >= N && "Mismatching buffer sizes.");
+
+	std::copy(y.begin(), y.end(), half_.begin());
+	InverseHalf_(out.data(), pool);
+}
+
+void MyDFT::Plan::ExecuteComplex(std::complex<float>* out, const std::complex<float>* in, MyUtils::ThreadPool* pool)
+{
+	if (out != in) std::copy(in, in + N, out);
+
+	if (N % 2 != 0)
+	{
+		shared_->realEngine.Transform(out, pool);
+		return;
+	}
+	if (!shared_->complexEngine) shared_->complexEngine = std::make_unique<FFTEngine>(N, direction);
+	shared_->complexEngine->Transform(out, pool);
+}
+
+void MyDFT::Plan::ExecuteDirect_(float* outRe, float* outIm, const float* inRe, const float* inIm, const size_t count, const size_t outputs, MyUtils::ThreadPool* pool)
+{
+	Kernels::DirectArgs args;
+	args.inRe = inRe;
+	args.inIm = inIm;
+	args.count = count;
+	args.cosTable = shared_->cosTable.data();
+	args.sinTable = shared_->sinTable.data();
+	args.N = N;
+	args.outBegin = 0;
+	args.outEnd = outputs;
+	args.outRe = outRe;
+	args.outIm = outIm;
+	args.sign = (direction == Direction::Inverse) ? 1.0f : -1.0f;
+
+	// Every output is independent: split them across the pool once there's enough work to amortize the synchronization.
+	if (!pool || count * outputs < FFTEngine::PARALLEL_MIN_LENGTH * 16)
+	{
+		shared_->realEngine.kernels.direct(args);
+		return;
+	}
+	const size_t grain = std::max((size_t)16, (size_t)(FFTEngine::PARALLEL_MIN_LENGTH * 4) / count);
+	pool->ParallelFor(0, outputs, grain, [&](const size_t begin, const size_t end)
+		{
+			Kernels::DirectArgs chunk = args;
+			chunk.outBegin = begin;
+			chunk.outEnd = end;
+			chunk.outRe = outRe + begin;
+			chunk.outIm = outIm ? outIm + begin : nullptr;
+			shared_->realEngine.kernels.direct(chunk);
+		});
+}
+
+void MyDFT::Plan::ExecuteBatch(std::complex<float>* out, const float* x, const size_t count)
+{
+	assert(direction == Direction::Forward && "Executing a real-to-complex transform on an inverse plan.");
+
+	if (direct_)
+	{
+		for (size_t frame = 0; frame < count; ++frame)
+		{
+			ExecuteDirect_(directRe_.data(), directIm_.data(), x + frame * N, nullptr, N, K, nullptr);
+			for (unsigned int k = 0; k < K; ++k)
+			{
+				out[frame * K + k] = std::complex<float>(directRe_[k], directIm_[k]);
+			}
+		}
+		return;
+	}
+
+	const size_t lanes = BatchLanes_();
+
+	for (size_t first = 0; first < count; first += lanes)
+	{
+		const size_t frames = std::min(lanes, count - first);
+		for (size_t l = 0; l < lanes; ++l)
+		{
+			if (l < frames) PackReal_(batchRe_.data() + l, batchIm_.data() + l, lanes, x + (first + l) * N);
+			else PackReal_(batchRe_.data() + l, batchIm_.data() + l, lanes, nullptr); // Pad the last group with silence.
+		}
+		shared_->realEngine.TransformInterleaved(batchRe_.data(), batchIm_.data(), lanes);
+		for (size_t l = 0; l < frames; ++l)
+		{
+			SplitHalf_(batchRe_.data() + l, batchIm_.data() + l, lanes);
+			SpreadBins_(out + (first + l) * K);
+		}
+	}
+}
+
+void MyDFT::Plan::ExecuteBatch(float* out, const std::complex<float>* y, const size_t count)
+{
+	assert(direction == Direction::Inverse && "Executing a complex-to-real transform on a forward plan.");
+
+	if (direct_)
+	{
+		const float scale = 1.0f / (float)N;
+		for (size_t frame = 0; frame < count; ++frame)
+		{
+			for (unsigned int k = 0; k < K; ++k)
+			{
+				directRe_[k] = y[frame * K + k].real();
+				directIm_[k] = y[frame * K + k].imag();
+			}
+			float* samples = out + frame * N;
+			ExecuteDirect_(samples, nullptr, directRe_.data(), directIm_.data(), K, N, nullptr);
+			for (unsigned int n = 0; n < N; ++n)
+			{
+				samples[n] *= scale;
+			}
+		}
+		return;
+	}
+
+	const size_t lanes = BatchLanes_();
+
+	for (size_t first = 0; first < count; first += lanes)
+	{
+		const size_t frames = std::min(lanes, count - first);
+		for (size_t l = 0; l < lanes; ++l)
+		{
+			if (l < frames) FoldBins_(y + (first + l) * K);
+			else std::fill(half_.begin(), half_.end(), std::complex<float>(0.0f, 0.0f));
+			MergeHalf_(batchRe_.data() + l, batchIm_.data() + l, lanes);
+		}
+		shared_->realEngine.TransformInterleaved(batchRe_.data(), batchIm_.data(), lanes);
+		for (size_t l = 0; l < frames; ++l)
+		{
+			UnpackReal_(out + (first + l) * N, batchRe_.data() + l, batchIm_.data() + l, lanes);
+		}
+	}
+}
+
+size_t MyDFT::Plan::BatchLanes_()
+{
+	// Lane l of value n of the batch buffer holds value n of frame l, so the engine runs every stage on whole vectors of frames.
+	// Long transforms already vectorize on their own: interleaving them only pushes the working set out of the L1 cache, so they go one frame at a time.
+	const size_t length = shared_->realEngine.length;
+	const size_t lanes = (length * shared_->realEngine.kernels.width <= BATCH_MAX_FLOATS) ? shared_->realEngine.kernels.width : 1;
+	if (batchRe_.size() < length * lanes)
+	{
+		batchRe_.resize(length * lanes);
+		batchIm_.resize(length * lanes);
+	}
+	return lanes;
+}
+
+void MyDFT::Plan::ForwardHalf_(const float* x, MyUtils::ThreadPool* pool)
+{
+	PackReal_(workRe_.data(), workIm_.data(), 1, x);
+	shared_->realEngine.TransformSplit(workRe_.data(), workIm_.data(), pool);
+	SplitHalf_(workRe_.data(), workIm_.data(), 1);
+}
+
+void MyDFT::Plan::InverseHalf_(float* out, MyUtils::ThreadPool* pool)
+{
+	MergeHalf_(workRe_.data(), workIm_.data(), 1);
+	shared_->realEngine.TransformSplit(workRe_.data(), workIm_.data(), pool);
+	UnpackReal_(out, workRe_.data(), workIm_.data(), 1);
+}
+
+void MyDFT::Plan::PackReal_(float* re, float* im, const size_t stride, const float* x) const
+{
+	const unsigned int length = shared_->realEngine.length;
+	if (!x)
+	{
+		for (unsigned int n = 0; n < length; ++n)
+		{
+			re[n * stride] = 0.0f;
+			im[n * stride] = 0.0f;
+		}
+		return;
+	}
+
+	if (N % 2 != 0)
+	{
+		for (unsigned int n = 0; n < N; ++n)
+		{
+			re[n * stride] = x[n];
+			im[n * stride] = 0.0f;
+		}
+		return;
+	}
+
+	// Pack the even samples in the real parts and the odd samples in the imaginary parts, then run an FFT of half the size.
+	for (unsigned int n = 0; n < length; ++n)
+	{
+		re[n * stride] = x[2 * n];
+		im[n * stride] = x[2 * n + 1];
+	}
+}
+
+void MyDFT::Plan::SplitHalf_(const float* re, const float* im, const size_t stride)
+{
+	if (N % 2 != 0)
+	{
+		for (unsigned int k = 0; k <= N / 2; ++k)
+		{
+			half_[k] = std::complex<float>(re[k * stride], im[k * stride]);
+		}
+		return;
+	}
+
+	// Split the spectrum Z of the packed signal: E[k] = (Z[k] + conj(Z[M-k])) / 2 is the spectrum of the even samples, O[k] = (Z[k] - conj(Z[M-k])) / 2i the one of the odd samples, and X[k] = E[k] + w^k * O[k].
+	const unsigned int M = N / 2;
+	for (unsigned int k = 0; k <= M; ++k)
+	{
+		const size_t i = (k % M) * stride;
+		const size_t iMirror = ((M - k) % M) * stride;
+		const std::complex<float> z(re[i], im[i]);
+		const std::complex<float> zMirror(re[iMirror], -im[iMirror]);
+		const std::complex<float> even = 0.5f * (z + zMirror);
+		const std::complex<float> diff = z - zMirror;
+		const std::complex<float> odd = std::complex<float>(0.5f * diff.imag(), -0.5f * diff.real());
+		half_[k] = even + shared_->realTwiddles[k] * odd;
+	}
+}
+
+void MyDFT::Plan::MergeHalf_(float* re, float* im, const size_t stride)
+{
+	// The imaginary parts of the DC and Nyquist bins don't exist in the spectrum of a real-valued signal.
+	half_[0] = std::complex<float>(half_[0].real(), 0.0f);
+	if (N % 2 == 0) half_[N / 2] = std::complex<float>(half_[N / 2].real(), 0.0f);
+
+	if (N % 2 != 0)
+	{
+		re[0] = half_[0].real();
+		im[0] = 0.0f;
+		for (unsigned int k = 1; k <= N / 2; ++k)
+		{
+			re[k * stride] = half_[k].real();
+			im[k * stride] = half_[k].imag();
+			re[(N - k) * stride] = half_[k].real();
+			im[(N - k) * stride] = -half_[k].imag();
+		}
+		return;
+	}
+
+	// Undo the split done in SplitHalf_(): rebuild 2 * (E[k] + i * O[k]) and run an N/2-point inverse FFT that yields the even samples in the real parts and the odd ones in the imaginary parts.
+	const unsigned int M = N / 2;
+	for (unsigned int k = 0; k < M; ++k)
+	{
+		const std::complex<float> h = half_[k];
+		const std::complex<float> hMirror = std::conj(half_[M - k]);
+		const std::complex<float> even = h + hMirror;
+		const std::complex<float> odd = (h - hMirror) * shared_->realTwiddles[k];
+		re[k * stride] = even.real() - odd.imag();
+		im[k * stride] = even.imag() + odd.real();
+	}
+}
+
+void MyDFT::Plan::UnpackReal_(float* out, const float* re, const float* im, const size_t stride) const
+{
+	const float scale = 1.0f / (float)N;
+
+	if (N % 2 != 0)
+	{
+		for (unsigned int n = 0; n < N; ++n)
+		{
+			out[n] = re[n * stride] * scale;
+		}
+		return;
+	}
+
+	for (unsigned int n = 0; n < N / 2; ++n)
+	{
+		out[2 * n] = re[n * stride] * scale;
+		out[2 * n + 1] = im[n * stride] * scale;
+	}
+}
+
+void MyDFT::Plan::SpreadBins_(std::complex<float>* out) const
+{
+	for (unsigned int k = 0; k < K; ++k)
+	{
+		const unsigned int bin = k % N; // Bins above N alias back onto the first N, exactly like the naive sum would.
+		out[k] = (bin <= N / 2) ? half_[bin] : std::conj(half_[N - bin]);
+	}
+}
+
+void MyDFT::Plan::FoldBins_(const std::complex<float>* y)
+{
+	// Keeping the real part of sum(y[k] * e^(i*2*PI*k*n/N)) is the same as transforming the Hermitian spectrum (Y[k] + conj(Y[N-k])) / 2, where Y is y folded onto N bins.
+	std::fill(half_.begin(), half_.end(), std::complex<float>(0.0f, 0.0f));
+	for (unsigned int k = 0; k < K; ++k)
+	{
+		const unsigned int bin = k % N;
+		const unsigned int mirror = (N - bin) % N;
+		if (bin <= N / 2) half_[bin] += 0.5f * y[k];
+		if (mirror <= N / 2) half_[mirror] += 0.5f * std::conj(y[k]);
+	}
+}
+
+std::shared_ptr<MyDFT::Plan> MyDFT::GetPlan(const unsigned int N, const unsigned int K, const Direction direction)
+{
+	// Most recently used first. A handful of entries, a linear search beats any map.
+	auto& plans = cachedPlans_;
+	for (size_t i = 0; i < plans.size(); ++i)
+	{
+		if (plans[i]->N != N || plans[i]->K != K || plans[i]->direction != direction) continue;
+		std::rotate(plans.begin(), plans.begin() + i, plans.begin() + i + 1);
+		return plans.front();
+	}
+
+	std::shared_ptr<Plan> plan;
+	for (const auto& cached : plans)
+	{
+		if (cached->N != N || cached->direction != direction) continue;
+		plan = std::make_shared<Plan>(*cached, K);
+		break;
+	}
+	if (!plan) plan = std::make_shared<Plan>(N, K, direction);
+
+	if (plans.size() == PLAN_CACHE_SIZE) plans.pop_back();
+	plans.insert(plans.begin(), plan);
+	return plan;
+}
+
+void MyDFT::ClearPlanCache()
+{
+	std::vector<std::shared_ptr<Plan>>().swap(cachedPlans_);
+}
@@ -0,0 +1,365 @@
+#include "MyFFTEngine.h"
+
+#include <cassert>
+#include <algorithm>
+
+#include "MyMath.h"
+#include "MyChirpZ.h"
+#include "MyFourStepFFT.h"
+#include "MyPlanner.h"
+
+MyDFT::FFTEngine::FFTEngine(const unsigned int length, const Direction direction, const Kernels::KernelTable* kernels):
+	FFTEngine(length, direction, kernels ? EstimateEngine(length, kernels->instructionSet) : PlanEngine(length, direction))
+{
+}
+
+MyDFT::FFTEngine::FFTEngine(const unsigned int length, const Direction direction, const EngineConfig& config):
+	length(length), direction(direction), kernels(*Kernels::GetKernels(config.instructionSet)), config_(config)
+{
+	assert(length > 0 && "Cannot transform an empty signal.");
+	assert(Kernels::GetKernels(config.instructionSet) && "Instruction set not supported by the CPU.");
+
+	if (config.fourStep)
+	{
+		fourStep_ = std::make_unique<FourStepFFT>(length, direction); // Owns its scratch buffers, the engine doesn't need any.
+		return;
+	}
+
+	// Twiddles are computed in double precision so that rounding errors don't accumulate with the index.
+	const double sign = (direction == Direction::Inverse) ? 1.0 : -1.0;
+	scratchRe_.resize(length);
+	scratchIm_.resize(length);
+
+	if (config.chirpZ)
+	{
+		chirpZ_ = std::make_unique<ChirpZ>(length, length, 0.0, -sign * 2.0 * MyMath::PI_D / (double)length);
+		return;
+	}
+
+	size_t n = length;
+	size_t s = 1;
+	for (const unsigned int p : config.radices)
+	{
+		assert(p >= 2 && n % p == 0 && "Radices don't multiply to the length.");
+		Stage stage;
+		stage.radix = p;
+		stage.m = n / p;
+		stage.s = s;
+		stage.twiddleOffset = twiddlesRe_.size();
+		stage.rootOffset = roots_.size();
+		stage.transposed = (this->kernels.width > 1) && (stage.m >= s); // Vectorize along whichever of j and q is the longest. Scalar kernels are faster without the extra transpose.
+
+		for (size_t t = 1; t < p; ++t)
+		{
+			for (size_t j = 0; j < stage.m; ++j)
+			{
+				const double angle = sign * 2.0 * MyMath::PI_D * (double)(j * t) / (double)n;
+				twiddlesRe_.push_back((float)std::cos(angle));
+				twiddlesIm_.push_back((float)std::sin(angle));
+			}
+		}
+		for (size_t t = 0; t < p; ++t)
+		{
+			const double angle = sign * 2.0 * MyMath::PI_D * (double)t / (double)p;
+			roots_.push_back(std::complex<float>((float)std::cos(angle), (float)std::sin(angle)));
+		}
+		stages_.push_back(stage);
+
+		n /= p;
+		s *= p;
+	}
+}
+
+MyDFT::FFTEngine::~FFTEngine() = default;
+
+std::vector<unsigned int> MyDFT::FFTEngine::Factorize(unsigned int length)
+{
+	std::vector<unsigned int> factors;
+	while (length % 4 == 0)
+	{
+		factors.push_back(4);
+		length /= 4;
+	}
+	unsigned int p = 2;
+	while (length > 1)
+	{
+		while (length % p == 0)
+		{
+			factors.push_back(p);
+			length /= p;
+		}
+		p = (p == 2) ? 3 : p + 2;
+		if (p * p > length && length > 1) // What remains is prime.
+		{
+			factors.push_back(length);
+			length = 1;
+		}
+	}
+	return factors;
+}
+
+const MyDFT::EngineConfig& MyDFT::FFTEngine::GetConfig() const
+{
+	return config_;
+}
+
+unsigned int MyDFT::FFTEngine::CostPerValue(const unsigned int length)
+{
+	if (length <= 1) return 0;
+
+	const std::vector<unsigned int> factors = Factorize(length);
+	if (factors.back() < BLUESTEIN_MIN_FACTOR)
+	{
+		unsigned int sum = 0;
+		for (const unsigned int p : factors)
+		{
+			sum += p;
+		}
+		return sum;
+	}
+
+	// Two transforms of the convolution length, the filter's is precomputed, plus the chirp products.
+	const unsigned int L = ChirpZ::SmoothLength(2 * length - 1);
+	return (unsigned int)((2 * (size_t)CostPerValue(L) + 3) * L / length);
+}
+
+void MyDFT::FFTEngine::Transform(std::complex<float>* data, MyUtils::ThreadPool* pool)
+{
+	if (splitRe_.size() != length)
+	{
+		// Only engines used with interleaved data pay for these buffers.
+		splitRe_.resize(length);
+		splitIm_.resize(length);
+	}
+
+	for (unsigned int i = 0; i < length; ++i)
+	{
+		splitRe_[i] = data[i].real();
+		splitIm_[i] = data[i].imag();
+	}
+	TransformSplit(splitRe_.data(), splitIm_.data(), pool);
+	for (unsigned int i = 0; i < length; ++i)
+	{
+		data[i] = std::complex<float>(splitRe_[i], splitIm_[i]);
+	}
+}
+
+void MyDFT::FFTEngine::TransformSplit(float* re, float* im, MyUtils::ThreadPool* pool)
+{
+	if (chirpZ_)
+	{
+		chirpZ_->ExecuteSplit(re, im, re, im, pool);
+		return;
+	}
+	if (fourStep_)
+	{
+		fourStep_->ExecuteSplit(re, im, pool);
+		return;
+	}
+	if (length < PARALLEL_MIN_LENGTH) pool = nullptr;
+
+	float* srcRe = re;
+	float* srcIm = im;
+	float* dstRe = scratchRe_.data();
+	float* dstIm = scratchIm_.data();
+	for (size_t i = 0; i < stages_.size(); ++i)
+	{
+		const Stage& stage = stages_[i];
+		if (i > 0 && stages_[i - 1].transposed && !stage.transposed)
+		{
+			Transpose_(stage, srcRe, srcIm, dstRe, dstIm, pool);
+			std::swap(srcRe, dstRe);
+			std::swap(srcIm, dstIm);
+		}
+		RunStage_(stage, srcRe, srcIm, dstRe, dstIm, pool);
+		std::swap(srcRe, dstRe);
+		std::swap(srcIm, dstIm);
+	}
+	if (srcRe != re) // Odd number of passes, the result landed in the scratch buffers.
+	{
+		std::copy(srcRe, srcRe + length, re);
+		std::copy(srcIm, srcIm + length, im);
+	}
+}
+
+void MyDFT::FFTEngine::TransformInterleaved(float* re, float* im, const size_t count, MyUtils::ThreadPool* pool)
+{
+	assert(count > 0 && "Cannot transform zero signals.");
+
+	if (count == 1)
+	{
+		TransformSplit(re, im, pool);
+		return;
+	}
+	if (chirpZ_ || fourStep_)
+	{
+		// Neither the convolution nor the passes interleave, transform the signals one by one.
+		if (scratchRe_.size() < length)
+		{
+			scratchRe_.resize(length);
+			scratchIm_.resize(length);
+		}
+		for (size_t l = 0; l < count; ++l)
+		{
+			for (size_t i = 0; i < length; ++i)
+			{
+				scratchRe_[i] = re[i * count + l];
+				scratchIm_[i] = im[i * count + l];
+			}
+			if (chirpZ_) chirpZ_->ExecuteSplit(scratchRe_.data(), scratchIm_.data(), scratchRe_.data(), scratchIm_.data(), pool);
+			else fourStep_->ExecuteSplit(scratchRe_.data(), scratchIm_.data(), pool);
+			for (size_t i = 0; i < length; ++i)
+			{
+				re[i * count + l] = scratchRe_[i];
+				im[i * count + l] = scratchIm_[i];
+			}
+		}
+		return;
+	}
+	if ((size_t)length * count < PARALLEL_MIN_LENGTH) pool = nullptr;
+	if (scratchRe_.size() < (size_t)length * count)
+	{
+		scratchRe_.resize((size_t)length * count);
+		scratchIm_.resize((size_t)length * count);
+	}
+
+	// Interleaving count signals turns index i of a signal into i * count + l: the same stages with count times the stride, always in the regular layout.
+	float* srcRe = re;
+	float* srcIm = im;
+	float* dstRe = scratchRe_.data();
+	float* dstIm = scratchIm_.data();
+	for (const Stage& stage : stages_)
+	{
+		Stage interleaved = stage;
+		interleaved.s *= count;
+		interleaved.transposed = false;
+		RunStage_(interleaved, srcRe, srcIm, dstRe, dstIm, pool);
+		std::swap(srcRe, dstRe);
+		std::swap(srcIm, dstIm);
+	}
+	if (srcRe != re)
+	{
+		std::copy(srcRe, srcRe + (size_t)length * count, re);
+		std::copy(srcIm, srcIm + (size_t)length * count, im);
+	}
+}
+
+void MyDFT::FFTEngine::RunStage_(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi, MyUtils::ThreadPool* pool) const
+{
+	if (!pool)
+	{
+		RunStageRange_(stage, xr, xi, yr, yi, 0, stage.m, 0, stage.s);
+		return;
+	}
+
+	// Chunks of a few thousand values at least, in multiples of the vector width so that only the last chunk has a scalar tail.
+	const size_t width = kernels.width;
+	const size_t extent = stage.transposed ? stage.m : stage.s;
+	const size_t valuesPerBlock = width * stage.radix * (stage.transposed ? stage.s : stage.m);
+	const size_t grain = std::max((size_t)1, (size_t)(PARALLEL_MIN_LENGTH / 8) / valuesPerBlock);
+	pool->ParallelFor(0, (extent + width - 1) / width, grain, [&](const size_t begin, const size_t end)
+		{
+			const size_t rangeBegin = begin * width;
+			const size_t rangeEnd = std::min(extent, end * width);
+			if (stage.transposed) RunStageRange_(stage, xr, xi, yr, yi, rangeBegin, rangeEnd, 0, stage.s);
+			else RunStageRange_(stage, xr, xi, yr, yi, 0, stage.m, rangeBegin, rangeEnd);
+		});
+}
+
+void MyDFT::FFTEngine::RunStageRange_(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi, const size_t jBegin, const size_t jEnd, const size_t qBegin, const size_t qEnd) const
+{
+	Kernels::StageArgs args;
+	args.xr = xr;
+	args.xi = xi;
+	args.yr = yr;
+	args.yi = yi;
+	args.twr = twiddlesRe_.data() + stage.twiddleOffset;
+	args.twi = twiddlesIm_.data() + stage.twiddleOffset;
+	args.m = stage.m;
+	args.s = stage.s;
+	args.jBegin = jBegin;
+	args.jEnd = jEnd;
+	args.qBegin = qBegin;
+	args.qEnd = qEnd;
+	args.transposed = stage.transposed;
+	args.inverse = (direction == Direction::Inverse);
+
+	switch (stage.radix)
+	{
+	case 2: kernels.radix2(args); break;
+	case 3: kernels.radix3(args); break;
+	case 4: kernels.radix4(args); break;
+	case 5: kernels.radix5(args); break;
+	default: RunGenericStage_(stage, xr, xi, yr, yi, jBegin, jEnd, qBegin, qEnd); break;
+	}
+}
+
+void MyDFT::FFTEngine::Transpose_(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi, MyUtils::ThreadPool* pool) const
+{
+	const size_t n = stage.m * stage.radix;
+	const size_t s = stage.s;
+	if (!pool)
+	{
+		kernels.transpose(xr, n, yr, s, s, n);
+		kernels.transpose(xi, n, yi, s, s, n);
+		return;
+	}
+
+	// Split along the rows, in multiples of 4 to keep the 4x4 tiles.
+	const size_t grain = std::max((size_t)1, (size_t)(PARALLEL_MIN_LENGTH / 8) / (4 * n));
+	pool->ParallelFor(0, (s + 3) / 4, grain, [&](const size_t begin, const size_t end)
+		{
+			const size_t rowBegin = begin * 4;
+			const size_t rows = std::min(s, end * 4) - rowBegin;
+			kernels.transpose(xr + rowBegin * n, n, yr + rowBegin, s, rows, n);
+			kernels.transpose(xi + rowBegin * n, n, yi + rowBegin, s, rows, n);
+		});
+}
+
+void MyDFT::FFTEngine::RunGenericStage_(const Stage& stage, const float* xr, const float* xi, float* yr, float* yi, const size_t jBegin, const size_t jEnd, const size_t qBegin, const size_t qEnd) const
+{
+	const size_t m = stage.m;
+	const size_t s = stage.s;
+	const unsigned int p = stage.radix;
+	const float* twr = twiddlesRe_.data() + stage.twiddleOffset;
+	const float* twi = twiddlesIm_.data() + stage.twiddleOffset;
+	const std::complex<float>* roots = roots_.data() + stage.rootOffset;
+
+	// Same indexing as the kernels, see Kernels::StageArgs.
+	const size_t inStride = stage.transposed ? m : s * m;
+	const size_t outStride = stage.transposed ? m * s : s;
+
+	for (size_t j = jBegin; j < jEnd; ++j)
+	{
+		for (size_t q = qBegin; q < qEnd; ++q)
+		{
+			const size_t in = stage.transposed ? j + p * m * q : q + s * j;
+			const size_t out = stage.transposed ? j + m * q : q + s * p * j;
+			for (size_t t = 0; t < p; ++t)
+			{
+				// Products written out, std::complex's operator* goes through a library call to handle infinities.
+				float accRe = xr[in];
+				float accIm = xi[in];
+				size_t root = 0;
+				for (size_t r = 1; r < p; ++r)
+				{
+					root = (root + t < p) ? root + t : root + t - p;
+					const float re = xr[in + r * inStride];
+					const float im = xi[in + r * inStride];
+					accRe += re * roots[root].real() - im * roots[root].imag();
+					accIm += re * roots[root].imag() + im * roots[root].real();
+				}
+				if (t > 0)
+				{
+					const float wRe = twr[(t - 1) * m + j];
+					const float wIm = twi[(t - 1) * m + j];
+					const float re = accRe;
+					accRe = re * wRe - accIm * wIm;
+					accIm = re * wIm + accIm * wRe;
+				}
+				yr[out + t * outStride] = accRe;
+				yi[out + t * outStride] = accIm;
+			}
+		}
+	}
+}
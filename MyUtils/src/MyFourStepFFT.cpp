@@ -0,0 +1,201 @@
+#include "MyFourStepFFT.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+
+#include "MyMath.h"
+
+MyDFT::FourStepFFT::Worker::Worker(const unsigned int rows, const unsigned int columns, const Direction direction):
+	columnEngine(rows, direction), rowEngine(columns, direction), blockRe(((size_t)rows + BLOCK) * BLOCK), blockIm(blockRe.size()), baseRe(rows), baseIm(rows)
+{
+}
+
+MyDFT::FourStepFFT::FourStepFFT(const unsigned int length, const Direction direction):
+	length(length), direction(direction), rows(SplitLength(length)), columns(length / SplitLength(length)),
+	coarseRe_(rows), coarseIm_(rows), fineRe_(columns), fineIm_(columns), blockTwiddlesRe_((size_t)rows * BLOCK), blockTwiddlesIm_((size_t)rows * BLOCK), scratchRe_((size_t)rows * (columns + BLOCK)), scratchIm_(scratchRe_.size())
+{
+	assert(rows > 1 && "Length can't be split, use an FFTEngine.");
+
+	// Twiddles are computed in double precision, the indices reach length.
+	const double sign = (direction == Direction::Inverse) ? 1.0 : -1.0;
+	const auto twiddle = [&](const size_t q, float& re, float& im)
+		{
+			const double angle = sign * 2.0 * MyMath::PI_D * (double)q / (double)length;
+			re = (float)std::cos(angle);
+			im = (float)std::sin(angle);
+		};
+	for (size_t i = 0; i < rows; ++i)
+	{
+		twiddle(i * columns, coarseRe_[i], coarseIm_[i]);
+	}
+	for (size_t j = 0; j < columns; ++j)
+	{
+		twiddle(j, fineRe_[j], fineIm_[j]);
+	}
+	for (size_t b = 0; b < BLOCK; ++b)
+	{
+		for (size_t k1 = 0; k1 < rows; ++k1)
+		{
+			twiddle(k1 * b, blockTwiddlesRe_[b * rows + k1], blockTwiddlesIm_[b * rows + k1]);
+		}
+	}
+
+	workers_.push_back(std::make_unique<Worker>(rows, columns, direction));
+	idleWorkers_.push_back(workers_.back().get());
+}
+
+MyDFT::FourStepFFT::~FourStepFFT() = default;
+
+void MyDFT::FourStepFFT::ExecuteSplit(float* re, float* im, MyUtils::ThreadPool* pool)
+{
+	// Every thread of the pool, and the calling one, may work on a chunk of blocks at the same time.
+	const size_t threads = pool ? (size_t)pool->GetThreadCount() + 1 : 1;
+	while (workers_.size() < threads)
+	{
+		workers_.push_back(std::make_unique<Worker>(rows, columns, direction));
+		idleWorkers_.push_back(workers_.back().get());
+	}
+
+	RunPass_(columns, pool, [&](Worker& worker, const size_t begin, const size_t end)
+		{
+			ColumnPass_(worker, re, im, begin, end);
+		});
+	RunPass_(rows, pool, [&](Worker& worker, const size_t begin, const size_t end)
+		{
+			RowPass_(worker, re, im, begin, end);
+		});
+}
+
+unsigned int MyDFT::FourStepFFT::SplitLength(const unsigned int length)
+{
+	for (unsigned int d = (unsigned int)std::sqrt((double)length); d > 1; --d)
+	{
+		if (length % d == 0) return d;
+	}
+	return 1;
+}
+
+void MyDFT::FourStepFFT::ColumnPass_(Worker& worker, const float* re, const float* im, const size_t begin, const size_t end)
+{
+	float* blockRe = worker.blockRe.data();
+	float* blockIm = worker.blockIm.data();
+	float* baseRe = worker.baseRe.data();
+	float* baseIm = worker.baseIm.data();
+	const size_t stride = rows + BLOCK; // Padded so that the columns of the block don't all map to the same cache sets when rows is a power of 2.
+	const size_t scratchStride = columns + BLOCK;
+	for (size_t c = begin; c < end; c += BLOCK)
+	{
+		const size_t width = std::min(BLOCK, end - c);
+
+		// Column c + b gathered contiguously at b * stride. Every row contributes a cache line.
+		for (size_t n1 = 0; n1 < rows; ++n1)
+		{
+			const float* xr = re + n1 * columns + c;
+			const float* xi = im + n1 * columns + c;
+			for (size_t b = 0; b < width; ++b)
+			{
+				blockRe[b * stride + n1] = xr[b];
+				blockIm[b * stride + n1] = xi[b];
+			}
+		}
+
+		// w_N^(k1 * c), the twiddles of the first column of the block.
+		for (size_t k1 = 0; k1 < rows; ++k1)
+		{
+			const size_t q = k1 * c;
+			const float cRe = coarseRe_[q / columns];
+			const float cIm = coarseIm_[q / columns];
+			const float fRe = fineRe_[q % columns];
+			const float fIm = fineIm_[q % columns];
+			baseRe[k1] = cRe * fRe - cIm * fIm;
+			baseIm[k1] = cRe * fIm + cIm * fRe;
+		}
+
+		// Y[k1][c + b] *= w_N^(k1 * (c + b)) = w_N^(k1 * c) * w_N^(k1 * b).
+		for (size_t b = 0; b < width; ++b)
+		{
+			float* yr = blockRe + b * stride;
+			float* yi = blockIm + b * stride;
+			worker.columnEngine.TransformSplit(yr, yi);
+
+			const float* twr = blockTwiddlesRe_.data() + b * rows;
+			const float* twi = blockTwiddlesIm_.data() + b * rows;
+			for (size_t k1 = 0; k1 < rows; ++k1)
+			{
+				const float wr = baseRe[k1] * twr[k1] - baseIm[k1] * twi[k1];
+				const float wi = baseRe[k1] * twi[k1] + baseIm[k1] * twr[k1];
+				const float xr = yr[k1];
+				const float xi = yi[k1];
+				yr[k1] = xr * wr - xi * wi;
+				yi[k1] = xr * wi + xi * wr;
+			}
+		}
+
+		// Scattered to the rows of the scratch buffers, a cache line each.
+		for (size_t k1 = 0; k1 < rows; ++k1)
+		{
+			float* yr = scratchRe_.data() + k1 * scratchStride + c;
+			float* yi = scratchIm_.data() + k1 * scratchStride + c;
+			for (size_t b = 0; b < width; ++b)
+			{
+				yr[b] = blockRe[b * stride + k1];
+				yi[b] = blockIm[b * stride + k1];
+			}
+		}
+	}
+}
+
+void MyDFT::FourStepFFT::RowPass_(Worker& worker, float* re, float* im, const size_t begin, const size_t end)
+{
+	const size_t stride = columns + BLOCK; // Rows of the scratch buffers, padded like the blocks of the column pass.
+	for (size_t r = begin; r < end; r += BLOCK)
+	{
+		const size_t height = std::min(BLOCK, end - r);
+		const float* xr = scratchRe_.data() + r * stride;
+		const float* xi = scratchIm_.data() + r * stride;
+
+		// The rows are contiguous already, transformed in place.
+		for (size_t b = 0; b < height; ++b)
+		{
+			worker.rowEngine.TransformSplit(scratchRe_.data() + (r + b) * stride, scratchIm_.data() + (r + b) * stride);
+		}
+
+		// X[k1 + rows * k2] for the rows k1 of the block, every k2 writes a cache line.
+		for (size_t k2 = 0; k2 < columns; ++k2)
+		{
+			float* yr = re + k2 * rows + r;
+			float* yi = im + k2 * rows + r;
+			for (size_t b = 0; b < height; ++b)
+			{
+				yr[b] = xr[b * stride + k2];
+				yi[b] = xi[b * stride + k2];
+			}
+		}
+	}
+}
+
+template<class PASS>
+void MyDFT::FourStepFFT::RunPass_(const size_t count, MyUtils::ThreadPool* pool, const PASS& pass)
+{
+	const size_t blocks = (count + BLOCK - 1) / BLOCK;
+	if (!pool)
+	{
+		pass(*workers_.front(), 0, count);
+		return;
+	}
+
+	pool->ParallelFor(0, blocks, 1, [&](const size_t begin, const size_t end)
+		{
+			Worker* worker = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(workersMutex_);
+				assert(!idleWorkers_.empty() && "More chunks running at once than threads.");
+				worker = idleWorkers_.back();
+				idleWorkers_.pop_back();
+			}
+			pass(*worker, begin * BLOCK, std::min(count, end * BLOCK));
+			std::lock_guard<std::mutex> lock(workersMutex_);
+			idleWorkers_.push_back(worker);
+		});
+}
@@ -0,0 +1,166 @@
+#include "MyGoertzel.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+
+#include "MyMath.h"
+
+// a * b. std::complex's operator* goes through a library call to handle infinities, which would dominate the cost of the segments.
+static inline std::complex<double> Multiply(const std::complex<double>& a, const std::complex<double>& b)
+{
+	return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+MyDFT::GoertzelBank::GoertzelBank(const std::vector<float>& frequencies, const float sampleRate):
+	kernels_(Kernels::GetKernels()), filters_(frequencies.size())
+{
+	assert(sampleRate > 0.0f && "Invalid sampling rate.");
+
+	// Lanes past the last filter are computed for nothing, but keep the kernel off its scalar leftovers path.
+	const size_t bins = frequencies.size();
+	const size_t width = kernels_.width;
+	coefficients_.resize((bins + width - 1) / width * width, 0.0f);
+	s1_.resize(coefficients_.size(), 0.0f);
+	s2_.resize(coefficients_.size(), 0.0f);
+	for (size_t b = 0; b < bins; ++b)
+	{
+		Filter& filter = filters_[b];
+		filter.omega = 2.0 * MyMath::PI_D * (double)frequencies[b] / (double)sampleRate;
+		filter.shift = std::polar(1.0, -filter.omega);
+		filter.step = std::polar(1.0, -filter.omega * (double)SEGMENT_LENGTH);
+		filter.rotation = std::polar(1.0, -filter.omega * (double)(SEGMENT_LENGTH - 1));
+		coefficients_[b] = (float)(2.0 * std::cos(filter.omega));
+	}
+
+	// A few frequencies would leave most lanes of the kernel empty, give each frequency several consecutive segments instead. Transposing the samples for every frequency only pays off with very few of them.
+	if (bins > 0 && 4 * bins <= width) lanesPerBin_ = 4 * width / bins;
+	laneCoefficients_.resize(bins * lanesPerBin_);
+	laneSamples_.resize(SEGMENT_LENGTH * bins * lanesPerBin_);
+	laneS1_.resize(bins * lanesPerBin_);
+	laneS2_.resize(bins * lanesPerBin_);
+}
+
+void MyDFT::GoertzelBank::Update(const float* samples, const size_t count)
+{
+	size_t done = 0;
+	while (done < count)
+	{
+		const size_t left = count - done;
+		const size_t segments = std::min(lanesPerBin_, left / SEGMENT_LENGTH);
+		if (segmentFill_ == 0 && segments > 1)
+		{
+			// Lane b * segments + j runs filter b over segment j.
+			const size_t lanes = filters_.size() * segments;
+			for (size_t b = 0; b < filters_.size(); ++b)
+			{
+				kernels_.transpose(samples + done, SEGMENT_LENGTH, laneSamples_.data() + b * segments, lanes, segments, SEGMENT_LENGTH);
+				std::fill(laneCoefficients_.begin() + b * segments, laneCoefficients_.begin() + (b + 1) * segments, coefficients_[b]);
+			}
+			std::fill(laneS1_.begin(), laneS1_.begin() + lanes, 0.0f);
+			std::fill(laneS2_.begin(), laneS2_.begin() + lanes, 0.0f);
+			kernels_.goertzel(laneSamples_.data(), lanes, SEGMENT_LENGTH, laneCoefficients_.data(), laneS1_.data(), laneS2_.data(), lanes);
+			for (size_t j = 0; j < segments; ++j)
+			{
+				Fold_(laneS1_.data() + j, laneS2_.data() + j, segments);
+			}
+			done += segments * SEGMENT_LENGTH;
+			continue;
+		}
+
+		const size_t length = std::min(left, SEGMENT_LENGTH - segmentFill_);
+		kernels_.goertzel(samples + done, 0, length, coefficients_.data(), s1_.data(), s2_.data(), coefficients_.size());
+		segmentFill_ += length;
+		done += length;
+		if (segmentFill_ < SEGMENT_LENGTH) continue;
+
+		Fold_(s1_.data(), s2_.data(), 1);
+		std::fill(s1_.begin(), s1_.end(), 0.0f);
+		std::fill(s2_.begin(), s2_.end(), 0.0f);
+		segmentFill_ = 0;
+	}
+	count_ += count;
+}
+
+void MyDFT::GoertzelBank::Update(const std::vector<float>& samples)
+{
+	Update(samples.data(), samples.size());
+}
+
+void MyDFT::GoertzelBank::GetSpectrum(std::vector<std::complex<float>>& out) const
+{
+	out.resize(filters_.size());
+	for (size_t b = 0; b < filters_.size(); ++b)
+	{
+		out[b] = std::complex<float>(filters_[b].bin + Partial_(b));
+	}
+}
+
+void MyDFT::GoertzelBank::GetPower(std::vector<float>& out) const
+{
+	out.resize(filters_.size());
+	for (size_t b = 0; b < filters_.size(); ++b)
+	{
+		out[b] = (float)std::norm(filters_[b].bin + Partial_(b));
+	}
+}
+
+void MyDFT::GoertzelBank::Reset()
+{
+	std::fill(s1_.begin(), s1_.end(), 0.0f);
+	std::fill(s2_.begin(), s2_.end(), 0.0f);
+	for (Filter& filter : filters_)
+	{
+		filter.rotation = std::polar(1.0, -filter.omega * (double)(SEGMENT_LENGTH - 1));
+		filter.bin = 0.0;
+	}
+	segmentFill_ = 0;
+	count_ = 0;
+}
+
+size_t MyDFT::GoertzelBank::GetSampleCount() const
+{
+	return count_;
+}
+
+void MyDFT::GoertzelBank::Fold_(const float* s1, const float* s2, const size_t stride)
+{
+	// The recurrence is a resonator: s1 - e^(-i*omega) * s2 = e^(i*omega*(SEGMENT_LENGTH-1)) * X, X being the DFT of the segment relative to its own start.
+	for (size_t b = 0; b < filters_.size(); ++b)
+	{
+		Filter& filter = filters_[b];
+		const std::complex<double> y = (double)s1[b * stride] - filter.shift * (double)s2[b * stride];
+		filter.bin += Multiply(y, filter.rotation);
+		filter.rotation = Multiply(filter.rotation, filter.step);
+	}
+}
+
+std::complex<double> MyDFT::GoertzelBank::Partial_(const size_t b) const
+{
+	if (segmentFill_ == 0) return 0.0;
+
+	// Same as Fold_(), with the rotation of a segment of segmentFill_ samples.
+	const Filter& filter = filters_[b];
+	const std::complex<double> y = (double)s1_[b] - filter.shift * (double)s2_[b];
+	return Multiply(y, Multiply(filter.rotation, std::polar(1.0, filter.omega * (double)(SEGMENT_LENGTH - segmentFill_))));
+}
+
+void MyDFT::Goertzel(std::vector<std::complex<float>>& out, const std::vector<float>& x, const std::vector<float>& bins)
+{
+	if (x.empty())
+	{
+		out.assign(bins.size(), std::complex<float>(0.0f, 0.0f));
+		return;
+	}
+
+	GoertzelBank bank(bins, (float)x.size());
+	bank.Update(x);
+	bank.GetSpectrum(out);
+}
+
+std::vector<std::complex<float>> MyDFT::Goertzel(const std::vector<float>& x, const std::vector<float>& bins)
+{
+	std::vector<std::complex<float>> out;
+	Goertzel(out, x, bins);
+	return out;
+}
@@ -0,0 +1,191 @@
+#include "MyMappedFile.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Size of the pages the file gets mapped with.
+static size_t PageSize()
+{
+#if defined(_WIN32)
+	static const size_t pageSize = []()
+		{
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			return (size_t)info.dwPageSize;
+		}();
+#else
+	static const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+	return pageSize;
+}
+
+MyUtils::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MyUtils::MappedFile::OpenRead(const char* path)
+{
+	Close();
+#if defined(_WIN32)
+	file_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE)
+	{
+		file_ = nullptr;
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file_, &size))
+	{
+		Close();
+		return false;
+	}
+	size_ = (size_t)size.QuadPart;
+#else
+	descriptor_ = open(path, O_RDONLY);
+	if (descriptor_ < 0) return false;
+	struct stat status;
+	if (fstat(descriptor_, &status) != 0)
+	{
+		Close();
+		return false;
+	}
+	size_ = (size_t)status.st_size;
+#endif
+	return Map_(false);
+}
+
+bool MyUtils::MappedFile::Create(const char* path, const size_t size)
+{
+	Close();
+	if (size == 0) return false;
+	size_ = size;
+#if defined(_WIN32)
+	file_ = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE)
+	{
+		file_ = nullptr;
+		return false;
+	}
+	// The mapping sets the size of the file.
+#else
+	descriptor_ = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (descriptor_ < 0) return false;
+	if (ftruncate(descriptor_, (off_t)size) != 0)
+	{
+		Close();
+		return false;
+	}
+#endif
+	return Map_(true);
+}
+
+void MyUtils::MappedFile::Close()
+{
+#if defined(_WIN32)
+	if (data_) UnmapViewOfFile(data_);
+	if (mapping_) CloseHandle(mapping_);
+	if (file_) CloseHandle(file_);
+	mapping_ = nullptr;
+	file_ = nullptr;
+#else
+	if (data_) munmap(data_, size_);
+	if (descriptor_ >= 0) close(descriptor_);
+	descriptor_ = -1;
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
+
+void MyUtils::MappedFile::Prefetch(const size_t offset, const size_t size) const
+{
+	if (!data_ || offset >= size_ || size == 0) return;
+
+	const size_t pageSize = PageSize();
+	const size_t begin = offset / pageSize * pageSize;
+	const size_t end = std::min(size_, offset + size);
+#if defined(_WIN32)
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = data_ + begin;
+	range.NumberOfBytes = end - begin;
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	madvise(data_ + begin, end - begin, MADV_WILLNEED);
+#endif
+}
+
+void MyUtils::MappedFile::Release(const size_t offset, const size_t size) const
+{
+	if (!data_ || offset >= size_) return;
+
+	const size_t pageSize = PageSize();
+	const size_t begin = (offset + pageSize - 1) / pageSize * pageSize;
+	const size_t end = (std::min(size_, offset + size) == size_) ? size_ : (offset + size) / pageSize * pageSize; // The last page of the file has nothing after it.
+	if (end <= begin) return;
+#if defined(_WIN32)
+	VirtualUnlock(data_ + begin, end - begin); // Pages that aren't locked leave the working set.
+#else
+	madvise(data_ + begin, end - begin, MADV_DONTNEED); // Dirty pages of a shared mapping stay in the page cache and get written back.
+#endif
+}
+
+bool MyUtils::MappedFile::IsOpen() const
+{
+	return data_ != nullptr;
+}
+
+char* MyUtils::MappedFile::GetData() const
+{
+	return data_;
+}
+
+size_t MyUtils::MappedFile::GetSize() const
+{
+	return size_;
+}
+
+bool MyUtils::MappedFile::Map_(const bool writable)
+{
+	if (size_ == 0)
+	{
+		Close();
+		return false;
+	}
+#if defined(_WIN32)
+	mapping_ = CreateFileMappingA(file_, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, (DWORD)((unsigned long long)size_ >> 32), (DWORD)(size_ & 0xFFFFFFFF), nullptr);
+	if (!mapping_)
+	{
+		Close();
+		return false;
+	}
+	data_ = (char*)MapViewOfFile(mapping_, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size_);
+	if (!data_)
+	{
+		Close();
+		return false;
+	}
+#else
+	void* data = mmap(nullptr, size_, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, descriptor_, 0);
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+	data_ = (char*)data;
+#endif
+	return true;
+}
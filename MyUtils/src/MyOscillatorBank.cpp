@@ -0,0 +1,82 @@
+#include "MyOscillatorBank.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+
+#include "MyMath.h"
+
+// a * b, without the library call std::complex's operator* makes to handle infinities.
+static inline std::complex<double> Multiply(const std::complex<double>& a, const std::complex<double>& b)
+{
+	return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+MyDFT::OscillatorBank::OscillatorBank(const std::vector<float>& frequencies, const std::vector<std::complex<float>>& amplitudes, const float sampleRate):
+	kernels_(Kernels::GetKernels()), blockLength_(BLOCK_VECTORS * kernels_.width), oscillators_(frequencies.size()), lanes_(Kernels::OSCILLATOR_VECTORS * kernels_.width)
+{
+	assert(sampleRate > 0.0f && "Invalid sampling rate.");
+	assert(frequencies.size() == amplitudes.size() && "One amplitude per frequency.");
+
+	laneRotations_.resize(oscillators_.size() * lanes_);
+	phasorsRe_.resize(oscillators_.size() * lanes_);
+	phasorsIm_.resize(oscillators_.size() * lanes_);
+	stepsRe_.resize(oscillators_.size());
+	stepsIm_.resize(oscillators_.size());
+	for (size_t j = 0; j < oscillators_.size(); ++j)
+	{
+		Oscillator& oscillator = oscillators_[j];
+		oscillator.omega = 2.0 * MyMath::PI_D * (double)frequencies[j] / (double)sampleRate;
+		oscillator.amplitude = std::complex<double>(amplitudes[j]);
+		oscillator.step = std::polar(1.0, oscillator.omega * (double)blockLength_);
+		oscillator.phasor = oscillator.amplitude;
+		for (size_t l = 0; l < lanes_; ++l)
+		{
+			laneRotations_[j * lanes_ + l] = std::polar(1.0, oscillator.omega * (double)l);
+		}
+		stepsRe_[j] = (float)std::cos(oscillator.omega * (double)lanes_);
+		stepsIm_[j] = (float)std::sin(oscillator.omega * (double)lanes_);
+	}
+}
+
+void MyDFT::OscillatorBank::Render(float* out, const size_t count)
+{
+	std::fill(out, out + count, 0.0f);
+
+	size_t done = 0;
+	while (done < count)
+	{
+		const size_t length = std::min(count - done, blockLength_);
+		for (size_t j = 0; j < oscillators_.size(); ++j)
+		{
+			for (size_t l = 0; l < lanes_; ++l)
+			{
+				const std::complex<double> phasor = Multiply(oscillators_[j].phasor, laneRotations_[j * lanes_ + l]);
+				phasorsRe_[j * lanes_ + l] = (float)phasor.real();
+				phasorsIm_[j * lanes_ + l] = (float)phasor.imag();
+			}
+		}
+		kernels_.oscillate(out + done, length, phasorsRe_.data(), phasorsIm_.data(), stepsRe_.data(), stepsIm_.data(), oscillators_.size());
+
+		// Only the last block of a call can be short, its step is worth one trigonometric call.
+		for (Oscillator& oscillator : oscillators_)
+		{
+			const std::complex<double> step = (length == blockLength_) ? oscillator.step : std::polar(1.0, oscillator.omega * (double)length);
+			oscillator.phasor = Multiply(oscillator.phasor, step);
+		}
+		done += length;
+	}
+}
+
+void MyDFT::OscillatorBank::Render(std::vector<float>& out)
+{
+	Render(out.data(), out.size());
+}
+
+void MyDFT::OscillatorBank::Reset()
+{
+	for (Oscillator& oscillator : oscillators_)
+	{
+		oscillator.phasor = oscillator.amplitude;
+	}
+}
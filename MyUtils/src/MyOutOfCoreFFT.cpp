@@ -0,0 +1,160 @@
+#include "MyOutOfCoreFFT.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+#include "MyMath.h"
+#include "MyMappedFile.h"
+
+static constexpr size_t BYTES_PER_BLOCK_VALUE = 2 * sizeof(float); // Blocks are held in split format.
+
+// Largest divisor of length no greater than its square root. FourStepFFT::SplitLength() for lengths beyond 32 bits.
+static size_t SplitLength(const size_t length)
+{
+	for (size_t d = (size_t)std::sqrt((double)length); d > 1; --d)
+	{
+		if (length % d == 0) return d;
+	}
+	return 1;
+}
+
+bool MyDFT::OutOfCoreFFT(const char* outputPath, const char* inputPath, const bool realInput, const Direction direction, const size_t memoryBudget, MyUtils::ThreadPool* pool)
+{
+	MyUtils::MappedFile input;
+	if (!input.OpenRead(inputPath)) return false;
+	const size_t length = input.GetSize() / (realInput ? sizeof(float) : sizeof(std::complex<float>));
+	if (length == 0) return false;
+
+	const size_t rows = SplitLength(length);
+	const size_t columns = length / rows;
+	if (columns > std::numeric_limits<unsigned int>::max()) return false; // Prime-ish length beyond what an FFTEngine transforms.
+
+	MyUtils::MappedFile output;
+	if (!output.Create(outputPath, length * sizeof(std::complex<float>))) return false;
+
+	const float* in = (const float*)input.GetData();
+	float* out = (float*)output.GetData(); // Interleaved real and imaginary parts.
+	const size_t inValues = realInput ? 1 : 2; // Floats per input value.
+	const size_t inBytes = inValues * sizeof(float);
+	const size_t outBytes = sizeof(std::complex<float>);
+
+	// Twiddle w_N^q is coarse[q / columns] * fine[q % columns], in double precision: q goes up to the length.
+	const double sign = (direction == Direction::Inverse) ? 1.0 : -1.0;
+	std::vector<std::complex<double>> coarse(rows);
+	std::vector<std::complex<double>> fine(columns);
+	for (size_t i = 0; i < rows; ++i)
+	{
+		coarse[i] = std::polar(1.0, sign * 2.0 * MyMath::PI_D * (double)(i * columns) / (double)length);
+	}
+	for (size_t j = 0; j < columns; ++j)
+	{
+		fine[j] = std::polar(1.0, sign * 2.0 * MyMath::PI_D * (double)j / (double)length);
+	}
+
+	// 1. Columns [c, c + width) of x[n1 * columns + n2]. Column c + b is written transposed at out[(c + b) * rows + k1].
+	{
+		FFTEngine engine((unsigned int)rows, direction);
+		const size_t width = std::clamp(memoryBudget / (BYTES_PER_BLOCK_VALUE * rows), (size_t)1, columns);
+		std::vector<float> blockRe(rows * width);
+		std::vector<float> blockIm(rows * width);
+		const auto prefetch = [&](const size_t c)
+			{
+				const size_t count = std::min(width, columns - c);
+				for (size_t n1 = 0; n1 < rows; ++n1)
+				{
+					input.Prefetch((n1 * columns + c) * inBytes, count * inBytes);
+				}
+			};
+
+		prefetch(0);
+		for (size_t c = 0; c < columns; c += width)
+		{
+			const size_t count = std::min(width, columns - c);
+			if (c + width < columns) prefetch(c + width);
+
+			for (size_t n1 = 0; n1 < rows; ++n1)
+			{
+				const float* x = in + (n1 * columns + c) * inValues;
+				for (size_t b = 0; b < count; ++b)
+				{
+					blockRe[b * rows + n1] = x[b * inValues];
+					blockIm[b * rows + n1] = realInput ? 0.0f : x[b * inValues + 1];
+				}
+				input.Release((n1 * columns + c) * inBytes, count * inBytes);
+			}
+
+			for (size_t b = 0; b < count; ++b)
+			{
+				float* yr = blockRe.data() + b * rows;
+				float* yi = blockIm.data() + b * rows;
+				engine.TransformSplit(yr, yi, pool);
+
+				// Y[k1][n2] *= w_N^(k1 * n2).
+				const size_t n2 = c + b;
+				float* y = out + n2 * rows * 2;
+				for (size_t k1 = 0; k1 < rows; ++k1)
+				{
+					const size_t q = k1 * n2;
+					const std::complex<double> w = coarse[q / columns] * fine[q % columns];
+					const float wr = (float)w.real();
+					const float wi = (float)w.imag();
+					y[2 * k1] = yr[k1] * wr - yi[k1] * wi;
+					y[2 * k1 + 1] = yr[k1] * wi + yi[k1] * wr;
+				}
+			}
+			output.Release(c * rows * outBytes, count * rows * outBytes);
+		}
+	}
+	input.Close();
+
+	// 2. Rows [r, r + height) of Y, at out[n2 * rows + k1]. Transformed in place, X[k1 + rows * k2] lands where it belongs.
+	{
+		FFTEngine engine((unsigned int)columns, direction);
+		const size_t height = std::clamp(memoryBudget / (BYTES_PER_BLOCK_VALUE * columns), (size_t)1, rows);
+		std::vector<float> blockRe(columns * height);
+		std::vector<float> blockIm(columns * height);
+		const auto prefetch = [&](const size_t r)
+			{
+				const size_t count = std::min(height, rows - r);
+				for (size_t n2 = 0; n2 < columns; ++n2)
+				{
+					output.Prefetch((n2 * rows + r) * outBytes, count * outBytes);
+				}
+			};
+
+		prefetch(0);
+		for (size_t r = 0; r < rows; r += height)
+		{
+			const size_t count = std::min(height, rows - r);
+			if (r + height < rows) prefetch(r + height);
+
+			for (size_t n2 = 0; n2 < columns; ++n2)
+			{
+				const float* y = out + (n2 * rows + r) * 2;
+				for (size_t b = 0; b < count; ++b)
+				{
+					blockRe[b * columns + n2] = y[2 * b];
+					blockIm[b * columns + n2] = y[2 * b + 1];
+				}
+			}
+			for (size_t b = 0; b < count; ++b)
+			{
+				engine.TransformSplit(blockRe.data() + b * columns, blockIm.data() + b * columns, pool);
+			}
+			for (size_t k2 = 0; k2 < columns; ++k2)
+			{
+				float* y = out + (k2 * rows + r) * 2;
+				for (size_t b = 0; b < count; ++b)
+				{
+					y[2 * b] = blockRe[b * columns + k2];
+					y[2 * b + 1] = blockIm[b * columns + k2];
+				}
+				output.Release((k2 * rows + r) * outBytes, count * outBytes);
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,302 @@
+#include "MyPlanner.h"
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include "MyFourStepFFT.h"
+
+static constexpr double MEASURE_MIN_SECONDS = 0.001; // Shortest timed run, repeating the transform as many times as needed. Well above the resolution of the clock.
+static constexpr int MEASURE_RUNS = 5; // Timed runs per candidate, the fastest one counts: the others were slowed down by something else.
+static constexpr unsigned int GENERIC_MAX_MEASURED_FACTOR = 31; // Largest prime factor whose generic O(p^2) stages get measured against a ChirpZ. Beyond that the ChirpZ always wins.
+static constexpr unsigned int FOUR_STEP_MIN_MEASURED_LENGTH = MyDFT::FFTEngine::FOUR_STEP_MIN_LENGTH / 16; // Smallest length whose FourStepFFT gets measured against the stages. The crossover depends on the cache of the CPU.
+static constexpr const char* CHIRPZ_TOKEN = "ChirpZ"; // Stands for the radices in the wisdom file when a length goes through a ChirpZ.
+static constexpr const char* FOUR_STEP_TOKEN = "FourStep"; // Stands for the radices in the wisdom file when a length goes through a FourStepFFT.
+
+// Wisdom of the process, shared by every thread.
+struct Wisdom
+{
+	std::mutex mutex;
+	std::map<unsigned int, MyDFT::EngineConfig> configs; // Decomposition of every length planned or loaded, measured ones only.
+	std::atomic<MyDFT::PlannerMode> mode = MyDFT::PlannerMode::Estimate;
+};
+
+static Wisdom& GetWisdom()
+{
+	static Wisdom wisdom;
+	return wisdom;
+}
+
+/**
+* Times an engine, in seconds per transform: the fastest of MEASURE_RUNS runs.
+* The engine transforms zeros over and over: the kernels cost the same whatever the values, and zeros can't overflow across the repetitions.
+*/
+static double TimeEngine(MyDFT::FFTEngine& engine)
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<float> re(engine.length, 0.0f), im(engine.length, 0.0f);
+	engine.TransformSplit(re.data(), im.data()); // Warm the caches up.
+
+	size_t repetitions = 1;
+	double best = std::numeric_limits<double>::max();
+	for (int run = 0; run < MEASURE_RUNS; ++run)
+	{
+		double seconds = 0.0;
+		while (true)
+		{
+			const Clock::time_point start = Clock::now();
+			for (size_t i = 0; i < repetitions; ++i)
+			{
+				engine.TransformSplit(re.data(), im.data());
+			}
+			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			if (seconds >= MEASURE_MIN_SECONDS || run > 0) break;
+			repetitions *= 2; // Only the first run calibrates the repetitions.
+		}
+		best = std::min(best, seconds / (double)repetitions);
+	}
+	return best;
+}
+
+/**
+* Orders of the radices worth measuring for a length: FFTEngine::Factorize()'s, its radix-2 stage first rather than last, the odd primes first, and radix-2 stages only. Duplicates removed.
+*/
+static std::vector<std::vector<unsigned int>> CandidateRadices(unsigned int length)
+{
+	unsigned int twos = 0;
+	while (length % 2 == 0)
+	{
+		++twos;
+		length /= 2;
+	}
+	const std::vector<unsigned int> odd = MyDFT::FFTEngine::Factorize(length); // Increasing order.
+
+	std::vector<std::vector<unsigned int>> candidates(4);
+	std::vector<unsigned int>& fours = candidates[0];
+	std::vector<unsigned int>& twoFirst = candidates[1];
+	std::vector<unsigned int>& oddFirst = candidates[2];
+	std::vector<unsigned int>& twosOnly = candidates[3];
+
+	if (twos % 2 != 0) twoFirst.push_back(2);
+	oddFirst.insert(oddFirst.end(), odd.rbegin(), odd.rend());
+	for (unsigned int i = 0; i < twos / 2; ++i)
+	{
+		fours.push_back(4);
+		twoFirst.push_back(4);
+		oddFirst.push_back(4);
+	}
+	if (twos % 2 != 0)
+	{
+		fours.push_back(2);
+		oddFirst.push_back(2);
+	}
+	twosOnly.assign(twos, 2);
+	for (std::vector<unsigned int>* candidate : { &fours, &twoFirst, &twosOnly })
+	{
+		candidate->insert(candidate->end(), odd.begin(), odd.end());
+	}
+
+	std::sort(candidates.begin() + 1, candidates.end());
+	candidates.erase(std::unique(candidates.begin() + 1, candidates.end()), candidates.end());
+	candidates.erase(std::remove(candidates.begin() + 1, candidates.end(), fours), candidates.end()); // Keep the default first, it wins ties.
+	return candidates;
+}
+
+/**
+* Parses the name of an instruction set written by Kernels::ToString().
+*/
+static bool ParseInstructionSet(const std::string& name, MyDFT::Kernels::InstructionSet& instructionSet)
+{
+	for (int i = (int)MyDFT::Kernels::InstructionSet::Scalar; i <= (int)MyDFT::Kernels::InstructionSet::AVX512; ++i)
+	{
+		if (name == MyDFT::Kernels::ToString((MyDFT::Kernels::InstructionSet)i))
+		{
+			instructionSet = (MyDFT::Kernels::InstructionSet)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+MyDFT::EngineConfig MyDFT::PlanEngine(const unsigned int length, const Direction direction)
+{
+	Wisdom& wisdom = GetWisdom();
+	{
+		std::lock_guard<std::mutex> lock(wisdom.mutex);
+		const auto it = wisdom.configs.find(length);
+		if (it != wisdom.configs.end()) return it->second;
+	}
+	if (wisdom.mode == PlannerMode::Estimate || length < 2) return EstimateEngine(length, Kernels::GetKernels().instructionSet);
+
+	// Measured without holding the lock, a ChirpZ candidate plans engines of its own. Threads measuring the same length at the same time all keep the first result.
+	const EngineConfig config = MeasureEngine(length, direction);
+	std::lock_guard<std::mutex> lock(wisdom.mutex);
+	return wisdom.configs.emplace(length, config).first->second;
+}
+
+MyDFT::EngineConfig MyDFT::EstimateEngine(const unsigned int length, const Kernels::InstructionSet instructionSet)
+{
+	EngineConfig config;
+	config.instructionSet = instructionSet;
+	config.radices = FFTEngine::Factorize(length);
+	config.chirpZ = !config.radices.empty() && config.radices.back() >= FFTEngine::BLUESTEIN_MIN_FACTOR;
+	config.fourStep = !config.chirpZ && length >= FFTEngine::FOUR_STEP_MIN_LENGTH;
+	if (config.chirpZ || config.fourStep) config.radices.clear();
+	return config;
+}
+
+MyDFT::EngineConfig MyDFT::MeasureEngine(const unsigned int length, const Direction direction)
+{
+	assert(length > 0 && "Cannot transform an empty signal.");
+
+	const Kernels::InstructionSet widest = Kernels::GetKernels().instructionSet;
+	const std::vector<unsigned int> factors = FFTEngine::Factorize(length);
+	const unsigned int largestFactor = factors.empty() ? 1 : factors.back();
+
+	EngineConfig best = EstimateEngine(length, widest);
+	double bestSeconds = std::numeric_limits<double>::max();
+	const auto measure = [&](const EngineConfig& config)
+		{
+			FFTEngine engine(length, direction, config);
+			const double seconds = TimeEngine(engine);
+			if (seconds < bestSeconds)
+			{
+				bestSeconds = seconds;
+				best = config;
+			}
+		};
+
+	// The radix orders with the widest kernels, then the narrower kernels with the fastest order. The product of both would take four times longer for little gain.
+	if (largestFactor <= GENERIC_MAX_MEASURED_FACTOR)
+	{
+		for (const std::vector<unsigned int>& radices : CandidateRadices(length))
+		{
+			EngineConfig config;
+			config.instructionSet = widest;
+			config.radices = radices;
+			measure(config);
+		}
+		const EngineConfig fastestOrder = best;
+		for (int i = (int)Kernels::InstructionSet::Scalar; i < (int)widest; ++i)
+		{
+			if (!Kernels::GetKernels((Kernels::InstructionSet)i)) continue; // Not compiled in.
+			EngineConfig config = fastestOrder;
+			config.instructionSet = (Kernels::InstructionSet)i;
+			measure(config);
+		}
+	}
+
+	// Generic stages for the primes without a dedicated kernel cost O(p) per value, a ChirpZ a constant factor over a smooth length.
+	if (largestFactor > 5)
+	{
+		EngineConfig config;
+		config.instructionSet = widest;
+		config.chirpZ = true;
+		measure(config);
+	}
+
+	// Lengths that may not fit in the cache, the FourStepFFT's sub-transforms are planned like any other.
+	if (largestFactor <= GENERIC_MAX_MEASURED_FACTOR && length >= FOUR_STEP_MIN_MEASURED_LENGTH && FourStepFFT::SplitLength(length) > 1)
+	{
+		EngineConfig config;
+		config.instructionSet = widest;
+		config.fourStep = true;
+		measure(config);
+	}
+	return best;
+}
+
+void MyDFT::SetPlannerMode(const PlannerMode mode)
+{
+	GetWisdom().mode = mode;
+}
+
+MyDFT::PlannerMode MyDFT::GetPlannerMode()
+{
+	return GetWisdom().mode;
+}
+
+bool MyDFT::LoadWisdom(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file) return false;
+
+	Wisdom& wisdom = GetWisdom();
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#') continue;
+
+		// length instruction-set radices..., length instruction-set ChirpZ or length instruction-set FourStep.
+		std::istringstream stream(line);
+		unsigned int length = 0;
+		std::string name;
+		EngineConfig config;
+		if (!(stream >> length >> name) || length == 0 || !ParseInstructionSet(name, config.instructionSet)) continue;
+		if (!Kernels::GetKernels(config.instructionSet)) continue; // Measured on a CPU with wider registers.
+
+		std::string token;
+		size_t product = 1;
+		bool valid = true;
+		while (valid && stream >> token)
+		{
+			if (token == CHIRPZ_TOKEN)
+			{
+				config.chirpZ = true;
+				continue;
+			}
+			if (token == FOUR_STEP_TOKEN)
+			{
+				config.fourStep = true;
+				continue;
+			}
+			const unsigned long radix = std::strtoul(token.c_str(), nullptr, 10);
+			valid = radix >= 2 && product * radix <= length;
+			config.radices.push_back((unsigned int)radix);
+			product *= radix;
+		}
+		if (config.fourStep && FourStepFFT::SplitLength(length) == 1) valid = false;
+		if (!valid || (config.chirpZ && config.fourStep) || ((config.chirpZ || config.fourStep) ? !config.radices.empty() : product != length)) continue;
+
+		std::lock_guard<std::mutex> lock(wisdom.mutex);
+		wisdom.configs[length] = config;
+	}
+	return true;
+}
+
+bool MyDFT::SaveWisdom(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file) return false;
+
+	Wisdom& wisdom = GetWisdom();
+	std::lock_guard<std::mutex> lock(wisdom.mutex);
+	file << "# MyDFT wisdom: length, instruction set, then the radices of the stages in execution order, " << CHIRPZ_TOKEN << " or " << FOUR_STEP_TOKEN << ".\n";
+	for (const auto& [length, config] : wisdom.configs)
+	{
+		file << length << ' ' << Kernels::ToString(config.instructionSet);
+		if (config.chirpZ) file << ' ' << CHIRPZ_TOKEN;
+		if (config.fourStep) file << ' ' << FOUR_STEP_TOKEN;
+		for (const unsigned int radix : config.radices)
+		{
+			file << ' ' << radix;
+		}
+		file << '\n';
+	}
+	return (bool)file;
+}
+
+void MyDFT::ForgetWisdom()
+{
+	Wisdom& wisdom = GetWisdom();
+	std::lock_guard<std::mutex> lock(wisdom.mutex);
+	wisdom.configs.clear();
+}
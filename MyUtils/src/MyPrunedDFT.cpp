@@ -0,0 +1,343 @@
+#include "MyPrunedDFT.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+
+#include "MyMath.h"
+
+// a * b, without the library call std::complex's operator* makes to handle infinities.
+static inline std::complex<float> Multiply(const std::complex<float>& a, const std::complex<float>& b)
+{
+	return std::complex<float>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+MyDFT::PrunedPlan::PrunedPlan(const unsigned int N, const unsigned int begin, const unsigned int end, const Direction direction):
+	N(N), begin(begin), end(end), direction(direction), kernels_(Kernels::GetKernels()), length_(N % 2 == 0 ? N / 2 : N)
+{
+	assert(N > 0 && "Cannot plan an empty transform.");
+	assert(begin < end && end <= N && "Invalid range.");
+
+	const size_t count = end - begin;
+	const bool packed = N % 2 == 0;
+	if (direction == Direction::Forward)
+	{
+		// Splitting bin k of the packed spectrum needs bin N'-k as well: the mirrored range, whose output count - 1 - i goes with bin begin + i.
+		ranges_.push_back({ begin % length_, count, 0 });
+		if (packed) ranges_.push_back({ (length_ - (end - 1) % length_) % length_, count, count });
+	}
+	else
+	{
+		// Output n of the packed inverse holds samples 2n and 2n+1.
+		if (packed) ranges_.push_back({ begin / 2, (end + 1) / 2 - begin / 2, 0 });
+		else ranges_.push_back({ begin, count, 0 });
+	}
+	for (const Range& range : ranges_)
+	{
+		outputs_ += range.length;
+	}
+	accRe_.resize(outputs_);
+	accIm_.resize(outputs_);
+
+	const double sign = (direction == Direction::Inverse) ? 1.0 : -1.0;
+	ChooseDecimation_();
+	if (decimation_ == 0)
+	{
+		cosTable_.resize(N);
+		sinTable_.resize(N);
+		for (unsigned int n = 0; n < N; ++n)
+		{
+			const double angle = 2.0 * MyMath::PI_D * (double)n / (double)N;
+			cosTable_[n] = (float)std::cos(angle);
+			sinTable_[n] = (float)std::sin(angle);
+		}
+		if (direction == Direction::Inverse)
+		{
+			workRe_.resize(N);
+			workIm_.resize(N);
+		}
+		return;
+	}
+
+	const size_t P = decimation_;
+	engine_ = std::make_unique<FFTEngine>((unsigned int)(length_ / P), direction);
+	workRe_.resize(length_);
+	workIm_.resize(length_);
+	if (direction == Direction::Inverse) folded_.resize(N);
+	if (P > 1)
+	{
+		gatherRe_.resize(P * outputs_);
+		gatherIm_.resize(P * outputs_);
+		twiddlesRe_.resize(P * outputs_);
+		twiddlesIm_.resize(P * outputs_);
+
+		// Every twiddle is a power of w_N', read from a table of its N' values rather than computing P * outputs_ exponentials.
+		std::vector<std::complex<double>> roots(length_);
+		for (size_t n = 0; n < length_; ++n)
+		{
+			roots[n] = std::polar(1.0, sign * 2.0 * MyMath::PI_D * (double)n / (double)length_);
+		}
+		for (const Range& range : ranges_)
+		{
+			for (size_t i = 0; i < range.length; ++i)
+			{
+				const size_t h = (range.first + i) % length_;
+				for (size_t r = 0; r < P; ++r)
+				{
+					const std::complex<double> twiddle = roots[(r * h) % length_];
+					twiddlesRe_[r * outputs_ + range.offset + i] = (float)twiddle.real();
+					twiddlesIm_[r * outputs_ + range.offset + i] = (float)twiddle.imag();
+				}
+			}
+		}
+	}
+
+	if (!packed) return;
+	const size_t splits = (direction == Direction::Forward) ? count : length_;
+	const size_t first = (direction == Direction::Forward) ? begin : 0;
+	splitTwiddles_.resize(splits);
+	for (size_t k = 0; k < splits; ++k)
+	{
+		const double angle = sign * 2.0 * MyMath::PI_D * (double)(first + k) / (double)N;
+		splitTwiddles_[k] = std::complex<float>((float)std::cos(angle), (float)std::sin(angle));
+	}
+}
+
+void MyDFT::PrunedPlan::Execute(std::vector<std::complex<float>>& out, const std::vector<float>& x, MyUtils::ThreadPool* pool)
+{
+	assert(direction == Direction::Forward && "Executing a real-to-complex transform on an inverse plan.");
+	assert(x.size() == N && out.size() >= end - begin && "Mismatching buffer sizes.");
+
+	const size_t count = end - begin;
+	if (decimation_ == 0)
+	{
+		ExecuteDirect_(accRe_.data(), accIm_.data(), x.data(), nullptr, N);
+		for (size_t i = 0; i < count; ++i)
+		{
+			out[i] = std::complex<float>(accRe_[i], accIm_[i]);
+		}
+		return;
+	}
+
+	if (N % 2 != 0)
+	{
+		std::copy(x.begin(), x.end(), workRe_.begin());
+		std::fill(workIm_.begin(), workIm_.end(), 0.0f);
+		Prune_(pool);
+		for (size_t i = 0; i < count; ++i)
+		{
+			out[i] = std::complex<float>(accRe_[i], accIm_[i]);
+		}
+		return;
+	}
+
+	// Even samples in the real parts, odd samples in the imaginary parts, like Plan.
+	for (size_t n = 0; n < length_; ++n)
+	{
+		workRe_[n] = x[2 * n];
+		workIm_[n] = x[2 * n + 1];
+	}
+	Prune_(pool);
+
+	// Same split as Plan: E[k] = (Z[k] + conj(Z[N'-k])) / 2, O[k] = (Z[k] - conj(Z[N'-k])) / 2i and X[k] = E[k] + w^k * O[k].
+	for (size_t i = 0; i < count; ++i)
+	{
+		const size_t mirror = 2 * count - 1 - i;
+		const std::complex<float> z(accRe_[i], accIm_[i]);
+		const std::complex<float> zMirror(accRe_[mirror], -accIm_[mirror]);
+		const std::complex<float> even = 0.5f * (z + zMirror);
+		const std::complex<float> diff = z - zMirror;
+		const std::complex<float> odd = std::complex<float>(0.5f * diff.imag(), -0.5f * diff.real());
+		out[i] = even + Multiply(splitTwiddles_[i], odd);
+	}
+}
+
+void MyDFT::PrunedPlan::Execute(std::vector<float>& out, const std::vector<std::complex<float>>& y, MyUtils::ThreadPool* pool)
+{
+	assert(direction == Direction::Inverse && "Executing a complex-to-real transform on a forward plan.");
+	assert(out.size() >= end - begin && "Mismatching buffer sizes.");
+
+	const size_t count = end - begin;
+	const float scale = 1.0f / (float)N;
+	if (decimation_ == 0)
+	{
+		std::fill(workRe_.begin(), workRe_.end(), 0.0f);
+		std::fill(workIm_.begin(), workIm_.end(), 0.0f);
+		for (size_t k = 0, bin = 0; k < y.size(); ++k, bin = (bin + 1 == N) ? 0 : bin + 1)
+		{
+			workRe_[bin] += y[k].real();
+			workIm_[bin] += y[k].imag();
+		}
+		ExecuteDirect_(out.data(), nullptr, workRe_.data(), workIm_.data(), N);
+		for (size_t i = 0; i < count; ++i)
+		{
+			out[i] *= scale;
+		}
+		return;
+	}
+
+	// Bins past N alias onto bin k % N.
+	const std::complex<float>* bins = y.data();
+	if (y.size() != N)
+	{
+		std::fill(folded_.begin(), folded_.end(), std::complex<float>(0.0f, 0.0f));
+		for (size_t k = 0, bin = 0; k < y.size(); ++k, bin = (bin + 1 == N) ? 0 : bin + 1)
+		{
+			folded_[bin] += y[k];
+		}
+		bins = folded_.data();
+	}
+
+	if (N % 2 != 0)
+	{
+		// Only the real parts of the outputs are kept, the bins go through as they are.
+		for (size_t k = 0; k < N; ++k)
+		{
+			workRe_[k] = bins[k].real();
+			workIm_[k] = bins[k].imag();
+		}
+		Prune_(pool);
+		for (size_t i = 0; i < count; ++i)
+		{
+			out[i] = accRe_[i] * scale;
+		}
+		return;
+	}
+
+	// Same merge as Plan in a single pass over the bins: keeping the real part of the sum is the same as transforming the Hermitian spectrum H[k] = (Y[k] + conj(Y[N-k])) / 2,
+	// and 2 * (E[k] + i * O[k]) = (H[k] + H[k+N']) + i * w^k * (H[k] - H[k+N']) has an N'-point inverse holding the even samples in its real parts and the odd ones in its imaginary parts.
+	for (size_t k = 0; k < length_; ++k)
+	{
+		const std::complex<float> low = 0.5f * (bins[k] + std::conj(bins[(k == 0) ? 0 : N - k]));
+		const std::complex<float> high = 0.5f * (bins[k + length_] + std::conj(bins[length_ - k]));
+		const std::complex<float> even = low + high;
+		const std::complex<float> odd = Multiply(low - high, splitTwiddles_[k]);
+		workRe_[k] = even.real() - odd.imag();
+		workIm_[k] = even.imag() + odd.real();
+	}
+	Prune_(pool);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const size_t n = begin + i;
+		const size_t o = n / 2 - begin / 2;
+		out[i] = ((n % 2 == 0) ? accRe_[o] : accIm_[o]) * scale;
+	}
+}
+
+unsigned int MyDFT::PrunedPlan::GetDecimation() const
+{
+	return (unsigned int)decimation_;
+}
+
+void MyDFT::PrunedPlan::ChooseDecimation_()
+{
+	// Same units as Plan: a direct sum costs one multiply-add per input and per output, an FFT CostPerValue() per value. Combining costs a gather and a multiply-add per output and per sub-sequence, plus a kernel call per sub-sequence.
+	double best = (double)N * (double)(end - begin);
+	decimation_ = 0;
+
+	const auto Consider = [&](const size_t P)
+	{
+		// The twiddle table holds P values per output, don't let it grow past a few times the signal.
+		if (P >= length_ || P * outputs_ > 4 * length_) return;
+		const double cost = (double)length_ * FFTEngine::CostPerValue((unsigned int)(length_ / P)) + 2.0 * (double)(P * (outputs_ + COMBINE_OVERHEAD));
+		if (cost < best)
+		{
+			best = cost;
+			decimation_ = P;
+		}
+	};
+	for (size_t p = 1; p * p <= length_; ++p)
+	{
+		if (length_ % p != 0) continue;
+		Consider(p);
+		Consider(length_ / p);
+	}
+}
+
+void MyDFT::PrunedPlan::Prune_(MyUtils::ThreadPool* pool)
+{
+	const size_t P = decimation_;
+	const size_t M = length_ / P;
+
+	// Value m of sub-sequence r sits at index m * P + r, the interleaved layout of the engine: the sub-transforms run in place, output q of sub-sequence r landing at q * P + r.
+	engine_->TransformInterleaved(workRe_.data(), workIm_.data(), P, pool);
+
+	if (P == 1)
+	{
+		// A full transform, the ranges are read as they are.
+		for (const Range& range : ranges_)
+		{
+			for (size_t i = 0; i < range.length; ++i)
+			{
+				const size_t h = (range.first + i) % length_;
+				accRe_[range.offset + i] = workRe_[h];
+				accIm_[range.offset + i] = workIm_[h];
+			}
+		}
+		return;
+	}
+
+	// Output h needs output h % M of every sub-sequence, a row of P values. Transpose the rows of each range into one contiguous run per sub-sequence.
+	for (const Range& range : ranges_)
+	{
+		for (size_t i = 0; i < range.length;)
+		{
+			const size_t q = (range.first + i) % M;
+			const size_t rows = std::min(range.length - i, M - q);
+			kernels_.transpose(workRe_.data() + q * P, P, gatherRe_.data() + range.offset + i, outputs_, rows, P);
+			kernels_.transpose(workIm_.data() + q * P, P, gatherIm_.data() + range.offset + i, outputs_, rows, P);
+			i += rows;
+		}
+	}
+
+	std::fill(accRe_.begin(), accRe_.end(), 0.0f);
+	std::fill(accIm_.begin(), accIm_.end(), 0.0f);
+	for (size_t r = 0; r < P; ++r)
+	{
+		kernels_.multiplyAccumulate(twiddlesRe_.data() + r * outputs_, twiddlesIm_.data() + r * outputs_, gatherRe_.data() + r * outputs_, gatherIm_.data() + r * outputs_, accRe_.data(), accIm_.data(), outputs_);
+	}
+}
+
+void MyDFT::PrunedPlan::ExecuteDirect_(float* outRe, float* outIm, const float* inRe, const float* inIm, const size_t count) const
+{
+	Kernels::DirectArgs args;
+	args.inRe = inRe;
+	args.inIm = inIm;
+	args.count = count;
+	args.cosTable = cosTable_.data();
+	args.sinTable = sinTable_.data();
+	args.N = N;
+	args.outBegin = begin;
+	args.outEnd = end;
+	args.outRe = outRe;
+	args.outIm = outIm;
+	args.sign = (direction == Direction::Inverse) ? 1.0f : -1.0f;
+	kernels_.direct(args);
+}
+
+void MyDFT::PrunedDFT(std::vector<std::complex<float>>& out, const std::vector<float>& x, const unsigned int k0, const unsigned int k1)
+{
+	assert(k0 <= k1 && "Invalid range.");
+
+	out.resize(k1 - k0);
+	if (k0 == k1) return;
+	if (x.empty())
+	{
+		std::fill(out.begin(), out.end(), std::complex<float>(0.0f, 0.0f));
+		return;
+	}
+
+	PrunedPlan plan((unsigned int)x.size(), k0, k1, Direction::Forward);
+	plan.Execute(out, x);
+}
+
+void MyDFT::PrunedIDFT(std::vector<float>& out, const std::vector<std::complex<float>>& y, const unsigned int N, const unsigned int n0, const unsigned int n1)
+{
+	assert(n0 <= n1 && "Invalid range.");
+
+	out.resize(n1 - n0);
+	if (n0 == n1) return;
+
+	PrunedPlan plan(N, n0, n1, Direction::Inverse);
+	plan.Execute(out, y);
+}
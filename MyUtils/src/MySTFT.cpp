@@ -0,0 +1,174 @@
+#include "MySTFT.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+
+#include "MyMath.h"
+
+std::vector<float> MyDFT::MakeWindow(const WindowType type, const unsigned int length)
+{
+	std::vector<float> window(length, 1.0f);
+	for (unsigned int n = 0; n < length; ++n)
+	{
+		const double phase = 2.0 * MyMath::PI_D * (double)n / (double)length;
+		switch (type)
+		{
+		case WindowType::Hann:
+			window[n] = (float)(0.5 - 0.5 * std::cos(phase));
+			break;
+		case WindowType::Hamming:
+			window[n] = (float)(0.54 - 0.46 * std::cos(phase));
+			break;
+		case WindowType::Blackman:
+			window[n] = (float)(0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+			break;
+		}
+	}
+	return window;
+}
+
+MyDFT::STFT::STFT(const unsigned int N, const unsigned int hop, const WindowType window, const bool padStart):
+	N(N), hop(hop), padStart(padStart), plan_(N, N / 2 + 1, Direction::Forward), window_(MakeWindow(window, N)), ring_(N, 0.0f), frame_(N, 0.0f), spectrum_(N / 2 + 1)
+{
+	assert(N > 0 && "Cannot transform empty frames.");
+	assert(hop > 0 && hop <= N && "The hop must be in [1, N], a larger one would skip samples.");
+
+	Reset();
+}
+
+void MyDFT::STFT::Push(const float* samples, size_t count, const FrameCallback& onFrame)
+{
+	pushed_ += count;
+	while (count > 0)
+	{
+		// Copy up to the next frame boundary, in at most two pieces around the end of the ring.
+		const size_t chunk = std::min(count, untilFrame_);
+		const size_t first = std::min(chunk, N - writePos_);
+		std::copy(samples, samples + first, ring_.begin() + writePos_);
+		std::copy(samples + first, samples + chunk, ring_.begin());
+		writePos_ = (writePos_ + chunk) % N;
+		samples += chunk;
+		count -= chunk;
+		untilFrame_ -= chunk;
+
+		if (untilFrame_ == 0)
+		{
+			EmitFrame_(onFrame);
+			untilFrame_ = hop;
+		}
+	}
+}
+
+void MyDFT::STFT::Push(const std::vector<float>& samples, const FrameCallback& onFrame)
+{
+	Push(samples.data(), samples.size(), onFrame);
+}
+
+void MyDFT::STFT::Flush(const FrameCallback& onFrame)
+{
+	// In padded stream coordinates frame f spans [f*hop, f*hop + N), and the pushed samples end at padding + pushed_.
+	// Without start padding the last frame only needs to reach the end. With it, the end gets padded symmetrically: frames keep coming until one starts within hop samples of the end, so the last samples are covered by as many frames as all the others.
+	static constexpr float ZEROS[64] = {};
+	const size_t padding = padStart ? N - hop : 0;
+	const size_t end = padding + pushed_;
+	const auto covered = [&]()
+	{
+		if (frameIndex_ == 0) return false;
+		const size_t last = (frameIndex_ - 1) * hop;
+		return padStart ? last + hop >= end : last + N >= end;
+	};
+	while (pushed_ > 0 && !covered())
+	{
+		Push(ZEROS, std::min((size_t)64, untilFrame_), onFrame);
+	}
+	Reset();
+}
+
+void MyDFT::STFT::Reset()
+{
+	std::fill(ring_.begin(), ring_.end(), 0.0f);
+	writePos_ = 0;
+	untilFrame_ = padStart ? hop : N;
+	frameIndex_ = 0;
+	pushed_ = 0;
+}
+
+const std::vector<float>& MyDFT::STFT::GetWindow() const
+{
+	return window_;
+}
+
+void MyDFT::STFT::EmitFrame_(const FrameCallback& onFrame)
+{
+	// The ring is full whenever a frame is due: its oldest sample is the one about to be overwritten.
+	const size_t tail = N - writePos_;
+	for (size_t n = 0; n < tail; ++n)
+	{
+		frame_[n] = ring_[writePos_ + n] * window_[n];
+	}
+	for (size_t n = tail; n < N; ++n)
+	{
+		frame_[n] = ring_[n - tail] * window_[n];
+	}
+
+	plan_.Execute(spectrum_, frame_);
+	onFrame(spectrum_, frameIndex_++);
+}
+
+MyDFT::ISTFT::ISTFT(const unsigned int N, const unsigned int hop, const WindowType window, const bool padStart):
+	N(N), hop(hop), padStart(padStart), plan_(N, N / 2 + 1, Direction::Inverse), window_(MakeWindow(window, N)), inverseNorm_(hop, 0.0f), accumulator_(N, 0.0f), frame_(N, 0.0f), out_(hop, 0.0f)
+{
+	assert(N > 0 && "Cannot transform empty frames.");
+	assert(hop > 0 && hop <= N && "The hop must be in [1, N], a larger one would leave gaps.");
+
+	for (unsigned int n = 0; n < hop; ++n)
+	{
+		double sum = 0.0;
+		for (unsigned int i = n; i < N; i += hop)
+		{
+			sum += (double)window_[i] * (double)window_[i];
+		}
+		inverseNorm_[n] = (sum > 1e-12) ? (float)(1.0 / sum) : 0.0f; // Samples no window covers can't be rebuilt, output silence rather than infinities.
+	}
+
+	Reset();
+}
+
+void MyDFT::ISTFT::PushFrame(const std::vector<std::complex<float>>& spectrum, const SampleCallback& onSamples)
+{
+	assert(spectrum.size() == N / 2 + 1 && "Frames hold bins 0 to N/2.");
+
+	plan_.ExecuteHermitian(frame_, spectrum);
+
+	// Overlap-add the windowed frame, in at most two pieces around the end of the ring.
+	const size_t tail = N - readPos_;
+	for (size_t n = 0; n < tail; ++n)
+	{
+		accumulator_[readPos_ + n] += frame_[n] * window_[n];
+	}
+	for (size_t n = tail; n < N; ++n)
+	{
+		accumulator_[n - tail] += frame_[n] * window_[n];
+	}
+
+	// No later frame reaches the first hop samples: normalize them and free their slots for the next frame's end.
+	for (size_t n = 0; n < hop; ++n)
+	{
+		float& sample = accumulator_[(readPos_ + n) % N];
+		out_[n] = sample * inverseNorm_[n];
+		sample = 0.0f;
+	}
+	readPos_ = (readPos_ + hop) % N;
+
+	const size_t dropped = std::min(toDrop_, (size_t)hop);
+	toDrop_ -= dropped;
+	if (dropped < hop) onSamples(out_.data() + dropped, hop - dropped);
+}
+
+void MyDFT::ISTFT::Reset()
+{
+	std::fill(accumulator_.begin(), accumulator_.end(), 0.0f);
+	readPos_ = 0;
+	toDrop_ = padStart ? N - hop : 0;
+}
@@ -0,0 +1,97 @@
+#include "MySlidingDFT.h"
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+
+#include "MyMath.h"
+
+MyDFT::SlidingDFT::SlidingDFT(const unsigned int N, const unsigned int K, const float damping, const size_t resyncInterval):
+	N(N), K(K), damping(damping), resyncInterval(resyncInterval), plan_(N, K, Direction::Forward), kernels_(Kernels::GetKernels()),
+	twiddlesRe_(K), twiddlesIm_(K), binsRe_(K, 0.0f), binsIm_(K, 0.0f), weights_(N), ring_(N, 0.0f), deltas_(N), frame_(N), spectrum_(K),
+	dampingN_((float)std::pow((double)damping, (double)N)), untilResync_(resyncInterval)
+{
+	assert(N > 0 && "Cannot slide an empty window.");
+	assert(K > 0 && "Cannot compute 0 bins.");
+	assert(damping > 0.0f && damping <= 1.0f && "Damping must be in (0, 1].");
+
+	for (size_t k = 0; k < K; ++k)
+	{
+		const double angle = 2.0 * MyMath::PI_D * (double)(k % N) / (double)N;
+		twiddlesRe_[k] = (float)((double)damping * std::cos(angle));
+		twiddlesIm_[k] = (float)((double)damping * std::sin(angle));
+	}
+	for (size_t m = 0; m < N; ++m)
+	{
+		weights_[m] = (float)std::pow((double)damping, (double)(N - m));
+	}
+}
+
+void MyDFT::SlidingDFT::Update(const float sample)
+{
+	Update(&sample, 1);
+}
+
+void MyDFT::SlidingDFT::Update(const float* samples, const size_t count)
+{
+	size_t done = 0;
+	while (done < count)
+	{
+		// At most N samples at a time, so that the samples leaving the window are still in the ring, and never past a resynchronization.
+		size_t length = std::min(count - done, (size_t)N);
+		if (resyncInterval > 0) length = std::min(length, untilResync_);
+
+		for (size_t i = 0; i < length; ++i)
+		{
+			const float sample = samples[done + i];
+			deltas_[i] = sample - dampingN_ * ring_[writePos_];
+			ring_[writePos_] = sample;
+			writePos_ = (writePos_ + 1 == N) ? 0 : writePos_ + 1;
+		}
+		kernels_.slide(deltas_.data(), length, twiddlesRe_.data(), twiddlesIm_.data(), binsRe_.data(), binsIm_.data(), K);
+		done += length;
+
+		if (resyncInterval == 0) continue;
+		untilResync_ -= length;
+		if (untilResync_ == 0) Resync();
+	}
+}
+
+void MyDFT::SlidingDFT::Update(const std::vector<float>& samples)
+{
+	Update(samples.data(), samples.size());
+}
+
+void MyDFT::SlidingDFT::GetSpectrum(std::vector<std::complex<float>>& out) const
+{
+	out.resize(K);
+	for (size_t k = 0; k < K; ++k)
+	{
+		out[k] = std::complex<float>(binsRe_[k], binsIm_[k]);
+	}
+}
+
+void MyDFT::SlidingDFT::Resync()
+{
+	for (size_t m = 0; m < N; ++m)
+	{
+		const size_t pos = writePos_ + m;
+		frame_[m] = weights_[m] * ring_[(pos < N) ? pos : pos - N];
+	}
+	plan_.Execute(spectrum_, frame_);
+	for (size_t k = 0; k < K; ++k)
+	{
+		binsRe_[k] = spectrum_[k].real();
+		binsIm_[k] = spectrum_[k].imag();
+	}
+	untilResync_ = resyncInterval;
+}
+
+void MyDFT::SlidingDFT::Reset()
+{
+	std::fill(ring_.begin(), ring_.end(), 0.0f);
+	std::fill(binsRe_.begin(), binsRe_.end(), 0.0f);
+	std::fill(binsIm_.begin(), binsIm_.end(), 0.0f);
+	writePos_ = 0;
+	untilResync_ = resyncInterval;
+}
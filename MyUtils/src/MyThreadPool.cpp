@@ -0,0 +1,149 @@
+#include "MyThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+
+// Pool and queue index of the worker running on this thread, so that Submit() from inside a task stays local.
+static thread_local const MyUtils::ThreadPool* currentPool_ = nullptr;
+static thread_local size_t currentQueue_ = 0;
+
+MyUtils::ThreadPool::ThreadPool(const unsigned int threadCount)
+{
+	const unsigned int count = (threadCount > 0) ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		queues_.push_back(std::make_unique<Queue>());
+	}
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		threads_.emplace_back(&ThreadPool::WorkerLoop_, this, (size_t)i);
+	}
+}
+
+MyUtils::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		stop_ = true;
+	}
+	sleepCv_.notify_all();
+	for (auto& thread : threads_)
+	{
+		thread.join();
+	}
+}
+
+void MyUtils::ThreadPool::Submit(std::function<void()> task)
+{
+	const size_t index = (currentPool_ == this) ? currentQueue_ : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+	{
+		std::lock_guard<std::mutex> lock(queues_[index]->m);
+		queues_[index]->tasks.push_back(std::move(task));
+	}
+	{
+		// Incrementing under the sleep mutex so that a worker can't check pending_ and go to sleep between the increment and the notification.
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		pending_.fetch_add(1, std::memory_order_release);
+	}
+	sleepCv_.notify_one();
+}
+
+void MyUtils::ThreadPool::ParallelFor(const size_t begin, const size_t end, const size_t grain, const std::function<void(size_t, size_t)>& body)
+{
+	if (end <= begin) return;
+
+	// A few chunks per thread so that the stealing can even out chunks of uneven cost.
+	const size_t count = end - begin;
+	const size_t threads = threads_.size() + 1; // The calling thread works too.
+	const size_t chunkSize = std::max(std::max(grain, (size_t)1), (count + 4 * threads - 1) / (4 * threads));
+	const size_t chunks = (count + chunkSize - 1) / chunkSize;
+	if (chunks == 1)
+	{
+		body(begin, end);
+		return;
+	}
+
+	std::atomic<size_t> remaining = chunks;
+	std::exception_ptr error = nullptr;
+	std::mutex errorMutex;
+	auto runChunk = [&](const size_t chunk)
+	{
+		const size_t chunkBegin = begin + chunk * chunkSize;
+		const size_t chunkEnd = std::min(end, chunkBegin + chunkSize);
+		try
+		{
+			body(chunkBegin, chunkEnd);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (!error) error = std::current_exception();
+		}
+		remaining.fetch_sub(1, std::memory_order_acq_rel); // Last access to the shared state: the caller may return as soon as this reaches 0.
+	};
+
+	for (size_t chunk = 1; chunk < chunks; ++chunk)
+	{
+		Submit([&runChunk, chunk]() { runChunk(chunk); });
+	}
+	runChunk(0);
+
+	// Help with whatever is queued rather than sleeping, some of it is likely our own chunks.
+	const size_t first = (currentPool_ == this) ? currentQueue_ : 0;
+	while (remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (!TryRunOne_(first)) std::this_thread::yield();
+	}
+
+	if (error) std::rethrow_exception(error);
+}
+
+unsigned int MyUtils::ThreadPool::GetThreadCount() const
+{
+	return (unsigned int)threads_.size();
+}
+
+bool MyUtils::ThreadPool::TryRunOne_(const size_t first)
+{
+	if (pending_.load(std::memory_order_acquire) == 0) return false;
+
+	std::function<void()> task;
+	const size_t count = queues_.size();
+	for (size_t i = 0; i < count && !task; ++i)
+	{
+		Queue& queue = *queues_[(first + i) % count];
+		std::lock_guard<std::mutex> lock(queue.m);
+		if (queue.tasks.empty()) continue;
+		if (i == 0)
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+	}
+	if (!task) return false;
+
+	pending_.fetch_sub(1, std::memory_order_acq_rel);
+	task();
+	return true;
+}
+
+void MyUtils::ThreadPool::WorkerLoop_(const size_t index)
+{
+	currentPool_ = this;
+	currentQueue_ = index;
+
+	while (true)
+	{
+		if (TryRunOne_(index)) continue;
+
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		sleepCv_.wait(lock, [this]() { return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+		if (stop_ && pending_.load(std::memory_order_acquire) == 0) return;
+	}
+}
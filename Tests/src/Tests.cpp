@@ -0,0 +1,129 @@
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "MyConvolution.h"
+#include "MyDFT.h"
+
+// Checks of MyUtils that don't need the Application. Returns the number of failed checks.
+// Usage: Tests.
+
+static int failures = 0;
+
+/**
+* Reports a check, counting it as failed if error exceeds tolerance.
+*/
+static void Check(const char* name, const double error, const double tolerance)
+{
+	const bool passed = error <= tolerance;
+	std::printf("%-60s %s (error %.3g, tolerance %.3g)\n", name, passed ? "passed" : "FAILED", error, tolerance);
+	if (!passed) ++failures;
+}
+
+/**
+* Deterministic pseudo-random samples in [-1, 1].
+*/
+static std::vector<float> Noise(const size_t count, unsigned int seed)
+{
+	std::vector<float> x(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		x[i] = (float)(seed >> 8) / (float)(1u << 23) - 1.0f;
+	}
+	return x;
+}
+
+/**
+* Streams signal through convolver block by block and returns the output.
+*/
+template<class CONVOLVER>
+static std::vector<float> Stream(CONVOLVER& convolver, const std::vector<float>& signal)
+{
+	std::vector<float> output(signal);
+	for (size_t i = 0; i + convolver.blockSize <= output.size(); i += convolver.blockSize)
+	{
+		convolver.Process(output.data() + i);
+	}
+	return output;
+}
+
+static double MaxDifference(const std::vector<float>& a, const std::vector<float>& b)
+{
+	double difference = 0.0;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		difference = std::max(difference, (double)std::abs(a[i] - b[i]));
+	}
+	return difference;
+}
+
+// A NonUniformConvolver filters like a time-domain convolution, and forgets its whole history on Reset(), the blocks being convolved in the background included.
+static void TestNonUniformConvolver(const bool background)
+{
+	const unsigned int blockSize = 64;
+	const std::vector<float> impulseResponse = Noise(3000, 1);
+	const std::vector<float> before = Noise(40 * blockSize, 2);
+	const std::vector<float> signal = Noise(80 * blockSize, 3);
+
+	std::vector<float> direct(signal.size(), 0.0f);
+	for (size_t n = 0; n < signal.size(); ++n)
+	{
+		double sum = 0.0;
+		for (size_t t = 0; t < impulseResponse.size() && t <= n; ++t)
+		{
+			sum += (double)impulseResponse[t] * (double)signal[n - t];
+		}
+		direct[n] = (float)sum;
+	}
+
+	MyDFT::NonUniformConvolver fresh(impulseResponse, blockSize, background, 512);
+	const std::vector<float> expected = Stream(fresh, signal);
+
+	MyDFT::NonUniformConvolver reset(impulseResponse, blockSize, background, 512);
+	Stream(reset, before);
+	reset.Reset();
+	const std::vector<float> output = Stream(reset, signal);
+
+	Check(background ? "NonUniformConvolver background, against direct convolution" : "NonUniformConvolver inline, against direct convolution", MaxDifference(expected, direct), 1e-3);
+	Check(background ? "NonUniformConvolver background, after Reset() against fresh" : "NonUniformConvolver inline, after Reset() against fresh", MaxDifference(output, expected), 1e-5);
+}
+
+// The Plans GetPlan() builds for several K share their engines, and still transform like the naive sums once the cache wrapped around.
+static void TestPlanCache()
+{
+	const unsigned int N = 1000;
+	const std::vector<float> x = Noise(N, 4);
+
+	double dftError = 0.0;
+	double idftError = 0.0;
+	for (unsigned int round = 0; round < 2; ++round)
+	{
+		for (unsigned int K = 1; K <= 2 * MyDFT::PLAN_CACHE_SIZE; ++K)
+		{
+			const unsigned int bins = K * 37; // Direct plans for the smallest K, FFT plans for the largest.
+			const std::vector<std::complex<float>> y = MyDFT::DFT(x, bins, false);
+			const std::vector<std::complex<float>> naiveY = MyDFT::NaiveDFT(x, bins, false);
+			for (unsigned int k = 0; k < bins; ++k)
+			{
+				dftError = std::max(dftError, (double)std::abs(y[k] - naiveY[k]));
+			}
+			idftError = std::max(idftError, MaxDifference(MyDFT::IDFT(naiveY, N, false), MyDFT::NaiveIDFT(naiveY, N, false)));
+		}
+	}
+	MyDFT::ClearPlanCache();
+
+	Check("DFT of varying K through the plan cache, against NaiveDFT", dftError, 1e-2);
+	Check("IDFT of varying K through the plan cache, against NaiveIDFT", idftError, 1e-3);
+}
+
+int main()
+{
+	TestNonUniformConvolver(false);
+	TestNonUniformConvolver(true);
+	TestPlanCache();
+
+	std::printf("%d check(s) failed.\n", failures);
+	return failures;
+}